@@ -0,0 +1,81 @@
+#include "BenchmarkHarness.h"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+namespace webview_plugin::benchmark {
+// Holds voiceCount notes low enough for all 64 partials to stay below the
+// Nyquist frequency, so that none of them is culled
+juce::var runAdditiveBenchmark(const Options& options) {
+  constexpr auto LOWEST_NOTE = 30;
+  constexpr auto NOTE_RANGE = 24;
+
+  const auto sampleRate = options.sampleRates.front();
+  const auto numChannels = options.channelCounts.front();
+
+  HarmonicTable table;
+  const auto values = createHarmonicValues(HarmonicTable::MAX_HARMONICS);
+  table.size = values.size();
+  std::copy(values.begin(), values.end(), table.values.begin());
+  const auto plan = PartialPlan::compile(table);
+
+  juce::Array<juce::var> results;
+
+  for (const auto voiceCount : options.voiceCounts) {
+    for (const auto blockSize : options.blockSizes) {
+      AdditiveSynth synth;
+      synth.prepare(sampleRate, blockSize);
+      synth.setPlan(plan);
+      for (auto voice = 0; voice < voiceCount; ++voice) {
+        synth.handleMidiEvent(juce::MidiMessage::noteOn(
+            1, LOWEST_NOTE + voice % NOTE_RANGE, 0.5f));
+      }
+
+      juce::AudioBuffer<float> buffer{numChannels, blockSize};
+      const auto numBlocks = juce::jmax(
+          1, static_cast<int>(
+                 std::ceil(options.secondsPerRun * sampleRate / blockSize)));
+      juce::int64 ticks = 0;
+
+      for (auto block = 0; block < numBlocks; ++block) {
+        buffer.clear();
+        const auto start = juce::Time::getHighResolutionTicks();
+        synth.render(juce::dsp::AudioBlock<float>{buffer});
+        ticks += juce::Time::getHighResolutionTicks() - start;
+      }
+
+      const auto seconds = juce::Time::highResolutionTicksToSeconds(ticks);
+      const auto numSamples = static_cast<double>(numBlocks) * blockSize;
+      const auto nanoseconds = 1e9 * seconds / numSamples;
+      const auto realtimeFactor =
+          seconds > 0.0 ? numSamples / sampleRate / seconds : 0.0;
+      const auto numPartials = synth.getNumActivePartials();
+
+      juce::DynamicObject::Ptr result{new juce::DynamicObject{}};
+      result->setProperty("voices", synth.getNumActiveVoices());
+      result->setProperty("partials", numPartials);
+      result->setProperty("blockSize", blockSize);
+      result->setProperty("nsPerSample", nanoseconds);
+      result->setProperty(
+          "nsPerPartialSample",
+          numPartials > 0 ? nanoseconds / numPartials : 0.0);
+      result->setProperty("realtimeFactor", realtimeFactor);
+      // Read so that nothing is optimized away
+      result->setProperty("check", buffer.getMagnitude(0, blockSize));
+      results.add(juce::var{result.get()});
+
+      std::cerr << synth.getNumActiveVoices() << " voices, " << numPartials
+                << " partials, " << blockSize << " samples: " << nanoseconds
+                << " ns/sample, " << realtimeFactor << "x realtime"
+                << std::endl;
+    }
+  }
+
+  juce::DynamicObject::Ptr report{new juce::DynamicObject{}};
+  report->setProperty("sampleRate", sampleRate);
+  report->setProperty("channels", numChannels);
+  report->setProperty("secondsPerRun", options.secondsPerRun);
+  report->setProperty("results", results);
+  return juce::var{report.get()};
+}
+}  // namespace webview_plugin::benchmark
@@ -0,0 +1,154 @@
+#include "BenchmarkHarness.h"
+#include "JuceWebViewTutorial/AssetStore.h"
+#include <algorithm>
+#include <cstddef>
+#include <iostream>
+#include <memory>
+#include <vector>
+
+namespace webview_plugin::benchmark {
+namespace {
+// Zips the web UI files like the plugin's build did before asset bundles
+juce::MemoryBlock createAssetZip(const juce::File& directory) {
+  juce::ZipFile::Builder builder;
+  for (const auto& entry : juce::RangedDirectoryIterator{
+           directory, true, "*", juce::File::findFiles}) {
+    builder.addFile(entry.getFile(), 9,
+                    directory.getFileName() + "/" +
+                        entry.getFile().getRelativePathFrom(directory)
+                            .replaceCharacter('\\', '/'));
+  }
+
+  juce::MemoryBlock zip;
+  juce::MemoryOutputStream stream{zip, false};
+  builder.writeToStream(stream, nullptr);
+  stream.flush();
+  return zip;
+}
+
+// What the editor did for every request before asset bundles existed
+std::vector<std::byte> fetchFromZip(const juce::MemoryBlock& zip,
+                                    const juce::String& path) {
+  juce::MemoryInputStream zipStream{zip, false};
+  juce::ZipFile zipFile{zipStream};
+
+  if (auto* zipEntry = zipFile.getEntry(path)) {
+    const std::unique_ptr<juce::InputStream> entryStream{
+        zipFile.createStreamForEntry(*zipEntry)};
+    if (entryStream != nullptr) {
+      juce::MemoryBlock bytes;
+      entryStream->readIntoMemoryBlock(bytes);
+      const auto* data = static_cast<const std::byte*>(bytes.getData());
+      return {data, data + bytes.getSize()};
+    }
+  }
+
+  return {};
+}
+
+// The copy that WebBrowserComponent::Resource requires
+std::vector<std::byte> fetchFromStore(const AssetStore& store,
+                                      const juce::String& path) {
+  const auto asset = store.get(path);
+  return asset.has_value()
+             ? std::vector<std::byte>(asset->bytes.begin(), asset->bytes.end())
+             : std::vector<std::byte>{};
+}
+
+template <typename Function>
+juce::var measureEditorOpens(int repetitions, Function&& openEditor) {
+  std::vector<double> seconds;
+  size_t totalBytes = 0;
+
+  for (auto i = 0; i < repetitions; ++i) {
+    const auto start = juce::Time::getHighResolutionTicks();
+    totalBytes = openEditor();
+    const auto end = juce::Time::getHighResolutionTicks();
+    seconds.push_back(juce::Time::highResolutionTicksToSeconds(end - start));
+  }
+
+  std::sort(seconds.begin(), seconds.end());
+  juce::DynamicObject::Ptr result{new juce::DynamicObject{}};
+  result->setProperty("p50Us", 1e6 * getPercentile(seconds, 0.5));
+  result->setProperty("minUs", 1e6 * seconds.front());
+  result->setProperty("maxUs", 1e6 * seconds.back());
+  result->setProperty("bytesPerOpen", static_cast<juce::int64>(totalBytes));
+  return juce::var{result.get()};
+}
+}  // namespace
+
+juce::var runAssetBenchmark(const Options& options) {
+  const auto zip = createAssetZip(options.assetsDirectory);
+  const auto prefix = options.assetsDirectory.getFileName() + "/";
+
+  juce::MemoryBlock bundle;
+  asset_bundle::PackStatistics statistics;
+  {
+    juce::MemoryOutputStream stream{bundle, false};
+    if (const auto result = asset_bundle::pack(options.assetsDirectory, stream,
+                                               statistics);
+        result.failed()) {
+      std::cerr << result.getErrorMessage() << std::endl;
+      return {};
+    }
+  }
+
+  // The files an editor requests
+  const auto paths =
+      AssetStore{bundle.getData(), bundle.getSize()}.getPaths();
+
+  if (paths.isEmpty()) {
+    std::cerr << "No web UI files in "
+              << options.assetsDirectory.getFullPathName() << std::endl;
+    return {};
+  }
+
+  const auto fetchAll = [&paths](auto&& fetch) {
+    size_t numBytes = 0;
+    for (const auto& path : paths) {
+      numBytes += fetch(path).size();
+    }
+    return numBytes;
+  };
+
+  const auto fetchAllFromStore = [&fetchAll](const AssetStore& store) {
+    return fetchAll(
+        [&store](const auto& path) { return fetchFromStore(store, path); });
+  };
+
+  const auto legacy = measureEditorOpens(options.repetitions, [&] {
+    return fetchAll(
+        [&](const auto& path) { return fetchFromZip(zip, prefix + path); });
+  });
+
+  const auto cold = measureEditorOpens(options.repetitions, [&] {
+    return fetchAllFromStore(AssetStore{bundle.getData(), bundle.getSize()});
+  });
+
+  const AssetStore sharedStore{bundle.getData(), bundle.getSize()};
+  fetchAllFromStore(sharedStore);
+  const auto warm = measureEditorOpens(
+      options.repetitions, [&] { return fetchAllFromStore(sharedStore); });
+
+  juce::DynamicObject::Ptr report{new juce::DynamicObject{}};
+  report->setProperty("numFiles", paths.size());
+  report->setProperty("inputBytes",
+                      static_cast<juce::int64>(statistics.inputBytes));
+  report->setProperty("zipBytes", static_cast<juce::int64>(zip.getSize()));
+  report->setProperty("bundleBytes",
+                      static_cast<juce::int64>(bundle.getSize()));
+  report->setProperty("repetitions", options.repetitions);
+  report->setProperty("legacyZipPerRequest", legacy);
+  report->setProperty("bundleCold", cold);
+  report->setProperty("bundleWarm", warm);
+
+  std::cerr << paths.size() << " files, zip " << zip.getSize()
+            << " bytes, bundle " << bundle.getSize()
+            << " bytes, p50 per editor open: legacy "
+            << legacy["p50Us"].toString() << " us, cold "
+            << cold["p50Us"].toString() << " us, warm "
+            << warm["p50Us"].toString() << " us" << std::endl;
+
+  return juce::var{report.get()};
+}
+}  // namespace webview_plugin::benchmark
@@ -0,0 +1,178 @@
+#include "BenchmarkHarness.h"
+#include "JuceWebViewTutorial/ParameterIDs.hpp"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+namespace webview_plugin::benchmark {
+namespace {
+// Rounding is all that may differ between sub-blocks and whole blocks
+constexpr auto MAX_SUB_BLOCK_DIFFERENCE = 1e-6;
+
+// Counts sub-blocks that don't follow each other, are longer than the maximum
+// or leave a MIDI event inside instead of starting at it
+int countSubBlockErrors(const Options& options) {
+  juce::Random random{42};
+  juce::MidiBuffer midi;
+  std::vector<int> subBlockStarts;
+  auto numErrors = 0;
+
+  for (auto repetition = 0; repetition < options.repetitions; ++repetition) {
+    for (const auto blockSize : options.blockSizes) {
+      midi.clear();
+      for (auto event = random.nextInt(16); event > 0; --event) {
+        midi.addEvent(juce::MidiMessage::noteOn(1, 60, juce::uint8{100}),
+                      random.nextInt(blockSize));
+      }
+
+      for (const auto maxSubBlockSize : options.subBlockSizes) {
+        subBlockStarts.clear();
+        auto end = 0;
+        forEachSubBlock(blockSize, midi, maxSubBlockSize,
+                        [&](int start, int length) {
+                          if (start != end || length <= 0 ||
+                              (maxSubBlockSize > 0 && length > maxSubBlockSize))
+                            ++numErrors;
+                          subBlockStarts.push_back(start);
+                          end = start + length;
+                        });
+
+        if (end != blockSize)
+          ++numErrors;
+
+        for (const auto metadata : midi) {
+          if (!std::binary_search(subBlockStarts.begin(), subBlockStarts.end(),
+                                  metadata.samplePosition))
+            ++numErrors;
+        }
+      }
+    }
+  }
+
+  return numErrors;
+}
+
+// Renders the looped input signal with gain and pan changing every few blocks
+juce::AudioBuffer<float> renderWithAutomation(double sampleRate,
+                                              int blockSize,
+                                              int maxSubBlockSize,
+                                              int numBlocks) {
+  AudioPluginAudioProcessor processor;
+  setParameter(processor, id::DISTORTION_TYPE, 1.f);
+  setParameter(processor, id::OVERSAMPLING, 1.f);
+  processor.setMaxSubBlockSize(maxSubBlockSize);
+  processor.setRateAndBufferSizeDetails(sampleRate, blockSize);
+  processor.prepareToPlay(sampleRate, blockSize);
+
+  const auto numChannels = processor.getTotalNumOutputChannels();
+  const auto signal = createInputSignal(numChannels, sampleRate);
+  juce::AudioBuffer<float> output{numChannels, numBlocks * blockSize};
+  juce::AudioBuffer<float> buffer{numChannels, blockSize};
+  juce::MidiBuffer midi;
+
+  for (auto block = 0; block < numBlocks; ++block) {
+    if (block % 3 == 0)
+      setParameter(processor, id::GAIN,
+                   0.25f + 0.25f * static_cast<float>((block / 3) % 4));
+    if (block % 5 == 0)
+      setParameter(processor, id::PAN,
+                   0.5f * static_cast<float>((block / 5) % 3));
+
+    const auto position = juce::int64{block} * blockSize;
+    fillInput(buffer, signal, position);
+    fillMidi(midi, position, blockSize, sampleRate);
+    processor.processBlock(buffer, midi);
+
+    for (auto channel = 0; channel < numChannels; ++channel) {
+      output.copyFrom(channel, block * blockSize, buffer, channel, 0,
+                      blockSize);
+    }
+  }
+
+  return output;
+}
+
+// Largest difference between rendering in sub-blocks and in whole blocks.
+// Ramps and filters carry their state sample by sample, so it should be 0.
+float getMaxSubBlockDifference(const Options& options) {
+  constexpr auto NUM_BLOCKS = 64;
+  const auto sampleRate = options.sampleRates.front();
+  auto maxDifference = 0.f;
+
+  for (const auto blockSize : options.blockSizes) {
+    const auto wholeBlocks =
+        renderWithAutomation(sampleRate, blockSize, 0, NUM_BLOCKS);
+
+    for (const auto maxSubBlockSize : options.subBlockSizes) {
+      const auto subBlocks = renderWithAutomation(sampleRate, blockSize,
+                                                  maxSubBlockSize, NUM_BLOCKS);
+      for (auto channel = 0; channel < wholeBlocks.getNumChannels();
+           ++channel) {
+        for (auto i = 0; i < wholeBlocks.getNumSamples(); ++i) {
+          maxDifference = juce::jmax(
+              maxDifference, std::abs(wholeBlocks.getSample(channel, i) -
+                                      subBlocks.getSample(channel, i)));
+        }
+      }
+    }
+  }
+
+  return maxDifference;
+}
+}  // namespace
+
+juce::var runAutomationBenchmark(const Options& options) {
+  const auto subBlockErrors = countSubBlockErrors(options);
+  const auto maxDifference = getMaxSubBlockDifference(options);
+
+  juce::Array<juce::var> results;
+  for (const auto blockSize : options.blockSizes) {
+    Configuration configuration{.sampleRate = options.sampleRates.front(),
+                                .blockSize = blockSize,
+                                .distortionType = 1,
+                                .numHarmonics = 16,
+                                .maxSubBlockSize = 0};
+    const auto wholeBlocks = run(configuration, options);
+
+    for (const auto maxSubBlockSize : options.subBlockSizes) {
+      configuration.maxSubBlockSize = maxSubBlockSize;
+      const auto subBlocks = run(configuration, options);
+      const auto overhead = wholeBlocks.nanosecondsPerSample > 0.0
+                                ? subBlocks.nanosecondsPerSample /
+                                          wholeBlocks.nanosecondsPerSample -
+                                      1.0
+                                : 0.0;
+
+      juce::DynamicObject::Ptr result{new juce::DynamicObject{}};
+      result->setProperty("blockSize", blockSize);
+      result->setProperty("subBlockSize", maxSubBlockSize);
+      result->setProperty("wholeBlockNsPerSample",
+                          wholeBlocks.nanosecondsPerSample);
+      result->setProperty("nsPerSample", subBlocks.nanosecondsPerSample);
+      result->setProperty("overhead", overhead);
+      results.add(juce::var{result.get()});
+
+      std::cerr << blockSize << " samples in sub-blocks of " << maxSubBlockSize
+                << ": " << subBlocks.nanosecondsPerSample << " ns/sample, "
+                << 100.0 * overhead << "% over whole blocks" << std::endl;
+    }
+  }
+
+  std::cerr << subBlockErrors << " sub-block errors, max difference to whole "
+            << "blocks " << maxDifference << std::endl;
+
+  juce::DynamicObject::Ptr report{new juce::DynamicObject{}};
+  report->setProperty("sampleRate", options.sampleRates.front());
+  report->setProperty("subBlockErrors", subBlockErrors);
+  report->setProperty("maxSubBlockDifference", maxDifference);
+  report->setProperty("results", results);
+  return juce::var{report.get()};
+}
+
+bool passesAutomationChecks(const juce::var& report) {
+  return static_cast<int>(report["subBlockErrors"]) == 0 &&
+         static_cast<double>(report["maxSubBlockDifference"]) <=
+             MAX_SUB_BLOCK_DIFFERENCE;
+}
+}  // namespace webview_plugin::benchmark
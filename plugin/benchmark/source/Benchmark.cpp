@@ -0,0 +1,154 @@
+#include "BenchmarkHarness.h"
+#include <juce_events/juce_events.h>
+#include <juce_gui_basics/juce_gui_basics.h>
+#include <iostream>
+
+/**
+ * Offline render benchmark of AudioPluginAudioProcessor. Each mode lives in a
+ * source file of its own and shares the harness in BenchmarkHarness.h.
+ *
+ * For every combination of channel count, sample rate, block size, distortion
+ * type, oversampling factor, bypass state and harmonic count, a fresh
+ * processor is prepared and fed with a synthetic signal plus a dense note pattern for a
+ * fixed duration. Reports ns/sample, the realtime factor and percentiles of
+ * the time spent in a single processBlock() call as JSON. ns/channel-sample
+ * shows how the cost scales with the channel count.
+ *
+ * With --mode=assets, measures instead how long fetching every web UI file
+ * takes when an editor opens: with the legacy per-request zip parsing, with a
+ * freshly created AssetStore over an asset bundle (the first editor of the
+ * process) and with a warm one (every further editor). Also reports the size
+ * of the zip and of the bundle.
+ *
+ * With --mode=state, saves and loads the state of a session's worth of
+ * differently configured instances, once with the plugin's binary state
+ * format and once through the parameters' ValueTree written as XML. Also
+ * checks that every instance comes back with the state it had, and exits with
+ * 1 if one doesn't.
+ *
+ * With --mode=automation, checks that blocks are split into sub-blocks at every
+ * MIDI event and that rendering with parameter changes in sub-blocks gives the
+ * same output as in whole blocks, exiting with 1 if not, then measures the
+ * cost of each sub-block size relative to whole blocks.
+ *
+ * With --mode=metering, measures the cost per sample of the output meters in
+ * every combination that can be switched on, next to the per-sample envelope
+ * follower that metered the output before.
+ *
+ * With --mode=instances, adds prepared instances one by one and reports the
+ * resident memory per instance at each requested count (Linux only).
+ *
+ * With --mode=additive, measures the internal additive synth holding each
+ * requested number of voices of a fully voiced 64-harmonic table.
+ *
+ * Usage:
+ *   JuceWebViewPluginBenchmark [--seconds=2] [--channels=2]
+ *       [--sample-rates=44100,96000] [--block-sizes=64,512,2048]
+ *       [--harmonics=0,16,64] [--oversampling=1,2,4,8] [--output=results.json]
+ *   JuceWebViewPluginBenchmark --mode=assets [--assets=path/to/ui/public]
+ *       [--repetitions=50] [--output=results.json]
+ *   JuceWebViewPluginBenchmark --mode=state [--instances=100]
+ *       [--repetitions=50] [--output=results.json]
+ *   JuceWebViewPluginBenchmark --mode=automation [--sub-block-sizes=16,32,64]
+ *       [--block-sizes=64,512,2048] [--repetitions=50] [--output=results.json]
+ *   JuceWebViewPluginBenchmark --mode=metering [--channels=2]
+ *       [--block-sizes=64,512,2048] [--seconds=2] [--output=results.json]
+ *   JuceWebViewPluginBenchmark --mode=instances [--instance-counts=1,10,100]
+ *       [--output=results.json]
+ *   JuceWebViewPluginBenchmark --mode=additive [--voices=1,16,64]
+ *       [--block-sizes=64,512,2048] [--seconds=2] [--output=results.json]
+ */
+namespace webview_plugin::benchmark {
+namespace {
+int runBenchmark(const juce::ArgumentList& arguments) {
+  if (arguments.containsOption("--help|-h")) {
+    std::cout << "Usage: " << arguments.executableName
+              << " [--seconds=2] [--channels=2] [--sample-rates=44100,96000]"
+                 " [--block-sizes=64,512,2048] [--harmonics=0,16,64]"
+                 " [--oversampling=1,2,4,8] [--output=results.json]\n"
+              << "       " << arguments.executableName
+              << " --mode=assets [--assets=path/to/ui/public]"
+                 " [--repetitions=50] [--output=results.json]\n"
+              << "       " << arguments.executableName
+              << " --mode=state [--instances=100] [--repetitions=50]"
+                 " [--output=results.json]\n"
+              << "       " << arguments.executableName
+              << " --mode=automation [--sub-block-sizes=16,32,64]"
+                 " [--block-sizes=64,512,2048] [--repetitions=50]"
+                 " [--output=results.json]\n"
+              << "       " << arguments.executableName
+              << " --mode=metering [--channels=2]"
+                 " [--block-sizes=64,512,2048] [--seconds=2]"
+                 " [--output=results.json]\n"
+              << "       " << arguments.executableName
+              << " --mode=instances [--instance-counts=1,10,100]"
+                 " [--output=results.json]\n"
+              << "       " << arguments.executableName
+              << " --mode=additive [--voices=1,16,64]"
+                 " [--block-sizes=64,512,2048] [--seconds=2]"
+                 " [--output=results.json]"
+              << std::endl;
+    return 0;
+  }
+
+  const auto options = parseOptions(arguments);
+
+  juce::var report;
+  if (options.mode == "render") {
+    report = runRenderBenchmark(options);
+  } else if (options.mode == "assets") {
+    report = runAssetBenchmark(options);
+  } else if (options.mode == "state") {
+    report = runStateBenchmark(options);
+  } else if (options.mode == "automation") {
+    report = runAutomationBenchmark(options);
+  } else if (options.mode == "metering") {
+    report = runMeteringBenchmark(options);
+  } else if (options.mode == "instances") {
+    report = runInstanceBenchmark(options);
+  } else if (options.mode == "additive") {
+    report = runAdditiveBenchmark(options);
+  } else {
+    std::cerr << "Unknown mode " << options.mode << std::endl;
+    return 1;
+  }
+
+  if (auto* object = report.getDynamicObject()) {
+    object->setProperty("mode", options.mode);
+#if JUCE_DEBUG
+    object->setProperty("build", "debug");
+#else
+    object->setProperty("build", "release");
+#endif
+  } else {
+    return 1;
+  }
+
+  const auto json = juce::JSON::toString(report);
+  if (options.outputFile == juce::File{}) {
+    std::cout << json << std::endl;
+  } else if (!options.outputFile.replaceWithText(json)) {
+    std::cerr << "Could not write " << options.outputFile.getFullPathName()
+              << std::endl;
+    return 1;
+  }
+
+  const auto passesChecks =
+      (options.mode != "state" || passesStateChecks(report)) &&
+      (options.mode != "automation" || passesAutomationChecks(report));
+  if (!passesChecks) {
+    std::cerr << "Checks of mode " << options.mode << " failed" << std::endl;
+    return 1;
+  }
+
+  return 0;
+}
+}  // namespace
+}  // namespace webview_plugin::benchmark
+
+int main(int argc, char* argv[]) {
+  // The processor relies on the message manager, e.g., for async updates
+  const juce::ScopedJuceInitialiser_GUI juceInitialiser;
+  return webview_plugin::benchmark::runBenchmark(
+      juce::ArgumentList{argc, argv});
+}
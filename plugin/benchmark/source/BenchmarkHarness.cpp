@@ -0,0 +1,269 @@
+#include "BenchmarkHarness.h"
+#include "JuceWebViewTutorial/ParameterIDs.hpp"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <numeric>
+#include <type_traits>
+
+namespace webview_plugin::benchmark {
+namespace {
+constexpr auto WARMUP_SECONDS = 0.1;
+// A note starts every NOTE_PERIOD_SECONDS and is held for 80% of the period
+constexpr auto NOTE_PERIOD_SECONDS = 0.05;
+
+template <typename T>
+std::vector<T> parseList(const juce::String& text) {
+  std::vector<T> result;
+  for (const auto& token : juce::StringArray::fromTokens(text, ",", "")) {
+    if constexpr (std::is_floating_point_v<T>) {
+      result.push_back(static_cast<T>(token.getDoubleValue()));
+    } else {
+      result.push_back(static_cast<T>(token.getIntValue()));
+    }
+  }
+  return result;
+}
+
+int getOversamplingIndex(int oversamplingFactor) {
+  const auto index =
+      static_cast<int>(std::lround(std::log2(juce::jmax(1, oversamplingFactor))));
+  return juce::jlimit(0, 3, index);
+}
+}  // namespace
+
+Options parseOptions(const juce::ArgumentList& arguments) {
+  Options options;
+
+  if (const auto value = arguments.getValueForOption("--mode");
+      value.isNotEmpty())
+    options.mode = value;
+  if (const auto value = arguments.getValueForOption("--seconds");
+      value.isNotEmpty())
+    options.secondsPerRun = value.getDoubleValue();
+  if (const auto value = arguments.getValueForOption("--channels");
+      value.isNotEmpty())
+    options.channelCounts = parseList<int>(value);
+  if (const auto value = arguments.getValueForOption("--sample-rates");
+      value.isNotEmpty())
+    options.sampleRates = parseList<double>(value);
+  if (const auto value = arguments.getValueForOption("--block-sizes");
+      value.isNotEmpty())
+    options.blockSizes = parseList<int>(value);
+  if (const auto value = arguments.getValueForOption("--harmonics");
+      value.isNotEmpty())
+    options.harmonicCounts = parseList<int>(value);
+  if (const auto value = arguments.getValueForOption("--oversampling");
+      value.isNotEmpty())
+    options.oversamplingFactors = parseList<int>(value);
+  if (const auto value = arguments.getValueForOption("--assets");
+      value.isNotEmpty())
+    options.assetsDirectory =
+        juce::File::getCurrentWorkingDirectory().getChildFile(value.unquoted());
+  if (const auto value = arguments.getValueForOption("--repetitions");
+      value.isNotEmpty())
+    options.repetitions = juce::jmax(1, value.getIntValue());
+  if (const auto value = arguments.getValueForOption("--instances");
+      value.isNotEmpty())
+    options.instances = juce::jmax(1, value.getIntValue());
+  if (const auto value = arguments.getValueForOption("--instance-counts");
+      value.isNotEmpty())
+    options.instanceCounts = parseList<int>(value);
+  if (const auto value = arguments.getValueForOption("--sub-block-sizes");
+      value.isNotEmpty())
+    options.subBlockSizes = parseList<int>(value);
+  if (const auto value = arguments.getValueForOption("--voices");
+      value.isNotEmpty())
+    options.voiceCounts = parseList<int>(value);
+  if (const auto value = arguments.getValueForOption("--output");
+      value.isNotEmpty())
+    options.outputFile = juce::File::getCurrentWorkingDirectory().getChildFile(
+        value.unquoted());
+
+  return options;
+}
+
+juce::AudioChannelSet getChannelLayout(int numChannels) {
+  switch (numChannels) {
+    case 1:
+      return juce::AudioChannelSet::mono();
+    case 2:
+      return juce::AudioChannelSet::stereo();
+    case 6:
+      return juce::AudioChannelSet::create5point1();
+    case 8:
+      return juce::AudioChannelSet::create7point1();
+    case 10:
+      return juce::AudioChannelSet::create7point1point2();
+    case 12:
+      return juce::AudioChannelSet::create7point1point4();
+    default:
+      return juce::AudioChannelSet::discreteChannels(numChannels);
+  }
+}
+
+void setParameter(AudioPluginAudioProcessor& processor,
+                  const juce::ParameterID& parameterId,
+                  float value) {
+  auto* parameter = processor.getState().getParameter(parameterId.getParamID());
+  jassert(parameter != nullptr);
+  parameter->setValueNotifyingHost(parameter->convertTo0to1(value));
+}
+
+juce::Array<float> createHarmonicValues(int numHarmonics) {
+  juce::Array<float> values;
+  for (auto i = 0; i < numHarmonics; ++i) {
+    values.add(
+        juce::jmax(5.f, std::floor(80.f * std::pow(0.75f, static_cast<float>(i)))));
+  }
+  return values;
+}
+
+juce::AudioBuffer<float> createInputSignal(int numChannels, double sampleRate) {
+  juce::AudioBuffer<float> signal{numChannels, static_cast<int>(sampleRate)};
+  juce::Random random{42};
+
+  for (auto channel = 0; channel < numChannels; ++channel) {
+    for (auto i = 0; i < signal.getNumSamples(); ++i) {
+      const auto phase = juce::MathConstants<double>::twoPi * 220.0 * i /
+                         sampleRate;
+      signal.setSample(channel, i,
+                       0.5f * static_cast<float>(std::sin(phase)) +
+                           0.1f * (2.f * random.nextFloat() - 1.f));
+    }
+  }
+
+  return signal;
+}
+
+void fillInput(juce::AudioBuffer<float>& buffer,
+               const juce::AudioBuffer<float>& signal,
+               juce::int64 startSample) {
+  for (auto i = 0; i < buffer.getNumSamples(); ++i) {
+    const auto signalIndex =
+        static_cast<int>((startSample + i) % signal.getNumSamples());
+    for (auto channel = 0; channel < buffer.getNumChannels(); ++channel) {
+      buffer.setSample(channel, i, signal.getSample(channel, signalIndex));
+    }
+  }
+}
+
+void fillMidi(juce::MidiBuffer& midi,
+              juce::int64 startSample,
+              int numSamples,
+              double sampleRate) {
+  midi.clear();
+
+  const auto period =
+      juce::jmax(juce::int64{1},
+                 static_cast<juce::int64>(NOTE_PERIOD_SECONDS * sampleRate));
+  const auto noteLength = period * 4 / 5;
+
+  for (auto sample = startSample; sample < startSample + numSamples;
+       ++sample) {
+    const auto positionInPeriod = sample % period;
+    const auto note = 48 + static_cast<int>((sample / period) % 24);
+    const auto time = static_cast<int>(sample - startSample);
+
+    if (positionInPeriod == 0)
+      midi.addEvent(juce::MidiMessage::noteOn(1, note, juce::uint8{100}), time);
+    else if (positionInPeriod == noteLength)
+      midi.addEvent(juce::MidiMessage::noteOff(1, note), time);
+  }
+}
+
+double getPercentile(const std::vector<double>& sortedValues,
+                     double percentile) {
+  if (sortedValues.empty())
+    return 0.0;
+
+  const auto index = static_cast<size_t>(
+      std::lround(percentile * static_cast<double>(sortedValues.size() - 1)));
+  return sortedValues[std::min(index, sortedValues.size() - 1)];
+}
+
+Result run(const Configuration& configuration, const Options& options) {
+  AudioPluginAudioProcessor processor;
+
+  juce::AudioProcessor::BusesLayout layout;
+  layout.inputBuses.add(getChannelLayout(configuration.numChannels));
+  layout.outputBuses.add(getChannelLayout(configuration.numChannels));
+  if (!processor.setBusesLayout(layout)) {
+    std::cerr << "Unsupported layout of " << configuration.numChannels
+              << " channels" << std::endl;
+    return {};
+  }
+
+  setParameter(processor, id::BYPASS, configuration.bypass ? 1.f : 0.f);
+  setParameter(processor, id::DISTORTION_TYPE,
+               static_cast<float>(configuration.distortionType));
+  setParameter(processor, id::HARMONIC_EXCITER,
+               configuration.harmonicExciter ? 1.f : 0.f);
+  setParameter(processor, id::OVERSAMPLING,
+               static_cast<float>(
+                   getOversamplingIndex(configuration.oversamplingFactor)));
+  processor.setHarmonicValues(createHarmonicValues(configuration.numHarmonics));
+  processor.setMaxSubBlockSize(configuration.maxSubBlockSize);
+
+  processor.setRateAndBufferSizeDetails(configuration.sampleRate,
+                                        configuration.blockSize);
+  processor.prepareToPlay(configuration.sampleRate, configuration.blockSize);
+
+  const auto numChannels = juce::jmax(processor.getTotalNumInputChannels(),
+                                      processor.getTotalNumOutputChannels());
+  juce::AudioBuffer<float> buffer{numChannels, configuration.blockSize};
+  juce::MidiBuffer midi;
+  midi.ensureSize(4096);
+  const auto signal = createInputSignal(numChannels, configuration.sampleRate);
+
+  const auto samplesToBlocks = [&](double seconds) {
+    return static_cast<int>(std::ceil(seconds * configuration.sampleRate /
+                                      configuration.blockSize));
+  };
+  const auto numWarmupBlocks = samplesToBlocks(WARMUP_SECONDS);
+  const auto numBlocks = juce::jmax(1, samplesToBlocks(options.secondsPerRun));
+
+  std::vector<double> blockSeconds;
+  blockSeconds.reserve(static_cast<size_t>(numBlocks));
+  juce::int64 position = 0;
+
+  for (auto block = -numWarmupBlocks; block < numBlocks; ++block) {
+    fillInput(buffer, signal, position);
+    fillMidi(midi, position, configuration.blockSize, configuration.sampleRate);
+
+    const auto start = juce::Time::getHighResolutionTicks();
+    processor.processBlock(buffer, midi);
+    const auto end = juce::Time::getHighResolutionTicks();
+
+    if (block >= 0)
+      blockSeconds.push_back(
+          juce::Time::highResolutionTicksToSeconds(end - start));
+
+    position += configuration.blockSize;
+  }
+
+  processor.releaseResources();
+
+  Result result;
+  const auto totalSeconds =
+      std::accumulate(blockSeconds.begin(), blockSeconds.end(), 0.0);
+  const auto numSamples =
+      static_cast<double>(numBlocks) * configuration.blockSize;
+  result.nanosecondsPerSample = 1e9 * totalSeconds / numSamples;
+  result.nanosecondsPerChannelSample =
+      result.nanosecondsPerSample / static_cast<double>(numChannels);
+  result.realtimeFactor =
+      totalSeconds > 0.0
+          ? numSamples / configuration.sampleRate / totalSeconds
+          : 0.0;
+
+  std::sort(blockSeconds.begin(), blockSeconds.end());
+  result.p50BlockMicroseconds = 1e6 * getPercentile(blockSeconds, 0.5);
+  result.p99BlockMicroseconds = 1e6 * getPercentile(blockSeconds, 0.99);
+  result.maxBlockMicroseconds = 1e6 * blockSeconds.back();
+  result.latencySamples = processor.getLatencySamples();
+  result.midiCapacityOverflows = processor.getNumMidiCapacityOverflows();
+
+  return result;
+}
+}  // namespace webview_plugin::benchmark
@@ -0,0 +1,104 @@
+#pragma once
+
+#include "JuceWebViewTutorial/PluginProcessor.h"
+#include <juce_audio_processors/juce_audio_processors.h>
+#include <vector>
+
+#ifndef WEBVIEW_PLUGIN_UI_DIR
+#define WEBVIEW_PLUGIN_UI_DIR ""
+#endif
+
+/**
+ * Shared harness of the benchmark modes: the command line options, the
+ * synthetic input signal and note pattern, and the timed offline render that
+ * several modes build on. Every mode lives in a source file of its own and
+ * returns its report as a JSON-compatible object.
+ */
+namespace webview_plugin::benchmark {
+struct Options {
+  juce::String mode{"render"};
+  double secondsPerRun = 2.0;
+  std::vector<int> channelCounts{2};
+  std::vector<double> sampleRates{44100.0, 96000.0};
+  std::vector<int> blockSizes{64, 512, 2048};
+  std::vector<int> harmonicCounts{0, 16, 64};
+  std::vector<int> oversamplingFactors{1, 2, 4, 8};
+  juce::File assetsDirectory{WEBVIEW_PLUGIN_UI_DIR};
+  int repetitions = 50;
+  int instances = 100;
+  std::vector<int> instanceCounts{1, 10, 100};
+  std::vector<int> subBlockSizes{16, 32, 64, 128};
+  std::vector<int> voiceCounts{1, 16, 64};
+  juce::File outputFile;
+};
+
+struct Configuration {
+  int numChannels = 2;
+  double sampleRate = 44100.0;
+  int blockSize = 512;
+  int distortionType = 0;
+  bool harmonicExciter = false;
+  int oversamplingFactor = 1;
+  bool bypass = false;
+  int numHarmonics = 0;
+  int maxSubBlockSize = AudioPluginAudioProcessor::DEFAULT_MAX_SUB_BLOCK_SIZE;
+};
+
+struct Result {
+  double nanosecondsPerSample = 0.0;
+  double nanosecondsPerChannelSample = 0.0;
+  double realtimeFactor = 0.0;
+  double p50BlockMicroseconds = 0.0;
+  double p99BlockMicroseconds = 0.0;
+  double maxBlockMicroseconds = 0.0;
+  int latencySamples = 0;
+  juce::uint32 midiCapacityOverflows = 0;
+};
+
+// Choices of the DISTORTION_TYPE parameter
+inline constexpr auto NUM_DISTORTION_TYPES = 3;
+
+Options parseOptions(const juce::ArgumentList& arguments);
+
+// The usual speaker layout of a channel count, e.g., 7.1.4 for 12
+juce::AudioChannelSet getChannelLayout(int numChannels);
+
+void setParameter(AudioPluginAudioProcessor& processor,
+                  const juce::ParameterID& parameterId,
+                  float value);
+
+// Same fall-off as the web UI's default harmonic amplitudes
+juce::Array<float> createHarmonicValues(int numHarmonics);
+
+// One second of a sine with some noise on top, looped during the render
+juce::AudioBuffer<float> createInputSignal(int numChannels, double sampleRate);
+
+void fillInput(juce::AudioBuffer<float>& buffer,
+               const juce::AudioBuffer<float>& signal,
+               juce::int64 startSample);
+
+// Adds the notes of the benchmark pattern that start or end within the block
+void fillMidi(juce::MidiBuffer& midi,
+              juce::int64 startSample,
+              int numSamples,
+              double sampleRate);
+
+double getPercentile(const std::vector<double>& sortedValues,
+                     double percentile);
+
+// Renders the looped input signal and notes through a fresh processor
+Result run(const Configuration& configuration, const Options& options);
+
+// The modes, see Benchmark.cpp
+juce::var runRenderBenchmark(const Options& options);
+juce::var runAssetBenchmark(const Options& options);
+juce::var runStateBenchmark(const Options& options);
+juce::var runAutomationBenchmark(const Options& options);
+juce::var runMeteringBenchmark(const Options& options);
+juce::var runInstanceBenchmark(const Options& options);
+juce::var runAdditiveBenchmark(const Options& options);
+
+// The checks the state and automation modes make along the way
+bool passesStateChecks(const juce::var& report);
+bool passesAutomationChecks(const juce::var& report);
+}  // namespace webview_plugin::benchmark
@@ -0,0 +1,78 @@
+#include "BenchmarkHarness.h"
+#include <algorithm>
+#include <iostream>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#if JUCE_LINUX
+#include <unistd.h>
+#endif
+
+namespace webview_plugin::benchmark {
+namespace {
+// Resident set size of the process, or 0 where /proc isn't available
+juce::int64 getResidentBytes() {
+#if JUCE_LINUX
+  const auto fields = juce::StringArray::fromTokens(
+      juce::File{"/proc/self/statm"}.loadFileAsString(), " ", "");
+  if (fields.size() < 2)
+    return 0;
+  return fields[1].getLargeIntValue() * sysconf(_SC_PAGESIZE);
+#else
+  return 0;
+#endif
+}
+}  // namespace
+
+// Adds instances one by one, like a host loading a session, and reports the
+// growth of the resident memory at every requested count. The first instance
+// also creates the shared resources.
+juce::var runInstanceBenchmark(const Options& options) {
+  constexpr auto SAMPLE_RATE = 48000.0;
+  constexpr auto BLOCK_SIZE = 512;
+
+  auto counts = options.instanceCounts;
+  std::sort(counts.begin(), counts.end());
+
+  const auto baselineBytes = getResidentBytes();
+  std::vector<std::unique_ptr<AudioPluginAudioProcessor>> instances;
+  juce::MidiBuffer midi;
+  juce::Array<juce::var> results;
+
+  for (const auto count : counts) {
+    while (std::cmp_less(instances.size(), count)) {
+      auto& processor = *instances.emplace_back(
+          std::make_unique<AudioPluginAudioProcessor>());
+      processor.setHarmonicValues(
+          createHarmonicValues(HarmonicTable::MAX_HARMONICS));
+      processor.setRateAndBufferSizeDetails(SAMPLE_RATE, BLOCK_SIZE);
+      processor.prepareToPlay(SAMPLE_RATE, BLOCK_SIZE);
+
+      // Touches the buffers allocated in prepareToPlay()
+      juce::AudioBuffer<float> buffer{processor.getTotalNumOutputChannels(),
+                                      BLOCK_SIZE};
+      buffer.clear();
+      processor.processBlock(buffer, midi);
+    }
+
+    const auto residentBytes = getResidentBytes();
+    const auto bytesPerInstance =
+        count > 0 ? (residentBytes - baselineBytes) / count : 0;
+
+    juce::DynamicObject::Ptr result{new juce::DynamicObject{}};
+    result->setProperty("instances", count);
+    result->setProperty("residentBytes", residentBytes);
+    result->setProperty("bytesPerInstance", bytesPerInstance);
+    results.add(juce::var{result.get()});
+
+    std::cerr << count << " instances: " << bytesPerInstance
+              << " resident bytes per instance" << std::endl;
+  }
+
+  juce::DynamicObject::Ptr report{new juce::DynamicObject{}};
+  report->setProperty("baselineResidentBytes", baselineBytes);
+  report->setProperty("results", results);
+  return juce::var{report.get()};
+}
+}  // namespace webview_plugin::benchmark
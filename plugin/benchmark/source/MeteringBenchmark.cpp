@@ -0,0 +1,141 @@
+#include "BenchmarkHarness.h"
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+
+namespace webview_plugin::benchmark {
+namespace {
+// How processBlock() metered before LevelMeter worked on whole blocks: a peak
+// envelope follower over every sample into a second buffer, of which only
+// the last sample of each channel was used, plus the RMS
+class LegacyMeter {
+public:
+  void prepare(double sampleRate, int numChannels, int blockSize) {
+    envelopeFollower.prepare(juce::dsp::ProcessSpec{
+        .sampleRate = sampleRate,
+        .maximumBlockSize = static_cast<juce::uint32>(blockSize),
+        .numChannels = static_cast<juce::uint32>(numChannels)});
+    envelopeFollower.setAttackTime(200.f);
+    envelopeFollower.setReleaseTime(200.f);
+    envelopeFollower.setLevelCalculationType(
+        juce::dsp::BallisticsFilter<float>::LevelCalculationType::peak);
+    envelopeFollowerOutputBuffer.setSize(numChannels, blockSize);
+  }
+
+  void process(const juce::dsp::AudioBlock<const float>& block) {
+    auto outBlock =
+        juce::dsp::AudioBlock<float>{envelopeFollowerOutputBuffer}.getSubBlock(
+            0u, block.getNumSamples());
+    envelopeFollower.process(
+        juce::dsp::ProcessContextNonReplacing<float>{block, outBlock});
+
+    const auto lastSample = static_cast<int>(block.getNumSamples()) - 1;
+    for (size_t channel = 0; channel < block.getNumChannels(); ++channel) {
+      peak = juce::jmax(peak, outBlock.getSample(static_cast<int>(channel),
+                                                 lastSample));
+      const auto* samples = block.getChannelPointer(channel);
+      for (size_t i = 0; i < block.getNumSamples(); ++i) {
+        squareSum += samples[i] * samples[i];
+      }
+    }
+  }
+
+  // Read after the measurement so that nothing is optimized away
+  float peak = 0.f;
+  float squareSum = 0.f;
+
+private:
+  juce::dsp::BallisticsFilter<float> envelopeFollower;
+  juce::AudioBuffer<float> envelopeFollowerOutputBuffer;
+};
+
+// Feeds the looped input signal to process block by block and returns the
+// time spent in it in ns/sample
+template <typename Process>
+double measureMeter(juce::AudioBuffer<float>& signal,
+                    int blockSize,
+                    double sampleRate,
+                    double seconds,
+                    Process&& process) {
+  const auto numBlocks = juce::jmax(
+      1, static_cast<int>(std::ceil(seconds * sampleRate / blockSize)));
+  const auto lastStart = signal.getNumSamples() - blockSize;
+  auto position = 0;
+  juce::int64 ticks = 0;
+
+  for (auto block = 0; block < numBlocks; ++block) {
+    const auto input = juce::dsp::AudioBlock<float>{signal}.getSubBlock(
+        static_cast<size_t>(position), static_cast<size_t>(blockSize));
+
+    const auto start = juce::Time::getHighResolutionTicks();
+    process(juce::dsp::AudioBlock<const float>{input});
+    ticks += juce::Time::getHighResolutionTicks() - start;
+
+    position = position + blockSize > lastStart ? 0 : position + blockSize;
+  }
+
+  return 1e9 * juce::Time::highResolutionTicksToSeconds(ticks) /
+         (static_cast<double>(numBlocks) * blockSize);
+}
+}  // namespace
+
+juce::var runMeteringBenchmark(const Options& options) {
+  struct MeterConfiguration {
+    const char* name;
+    std::uint8_t meters;
+  };
+  constexpr std::array meterConfigurations{
+      MeterConfiguration{"peak+rms", LevelMeter::peak | LevelMeter::rms},
+      MeterConfiguration{"truePeak", LevelMeter::truePeak},
+      MeterConfiguration{"loudness", LevelMeter::loudness},
+      MeterConfiguration{"all", LevelMeter::allMeters}};
+
+  const auto sampleRate = options.sampleRates.front();
+  juce::Array<juce::var> results;
+
+  for (const auto numChannels : options.channelCounts) {
+    auto signal = createInputSignal(numChannels, sampleRate);
+
+    for (const auto blockSize : options.blockSizes) {
+      LegacyMeter legacyMeter;
+      legacyMeter.prepare(sampleRate, numChannels, blockSize);
+      const auto legacyNanoseconds = measureMeter(
+          signal, blockSize, sampleRate, options.secondsPerRun,
+          [&legacyMeter](const auto& block) { legacyMeter.process(block); });
+
+      juce::DynamicObject::Ptr result{new juce::DynamicObject{}};
+      result->setProperty("channels", numChannels);
+      result->setProperty("blockSize", blockSize);
+      result->setProperty("legacyNsPerSample", legacyNanoseconds);
+      result->setProperty("legacyCheck",
+                          legacyMeter.peak + legacyMeter.squareSum);
+
+      std::cerr << numChannels << " channels, " << blockSize
+                << " samples: legacy " << legacyNanoseconds << " ns/sample";
+
+      for (const auto& [name, meters] : meterConfigurations) {
+        LevelMeter levelMeter;
+        levelMeter.prepare(sampleRate, getChannelLayout(numChannels),
+                           blockSize);
+        levelMeter.setEnabledMeters(meters);
+        const auto nanoseconds = measureMeter(
+            signal, blockSize, sampleRate, options.secondsPerRun,
+            [&levelMeter](const auto& block) { levelMeter.process(block); });
+
+        result->setProperty(juce::String{name} + "NsPerSample", nanoseconds);
+        std::cerr << ", " << name << " " << nanoseconds << " ns/sample";
+      }
+
+      std::cerr << std::endl;
+      results.add(juce::var{result.get()});
+    }
+  }
+
+  juce::DynamicObject::Ptr report{new juce::DynamicObject{}};
+  report->setProperty("sampleRate", sampleRate);
+  report->setProperty("secondsPerRun", options.secondsPerRun);
+  report->setProperty("results", results);
+  return juce::var{report.get()};
+}
+}  // namespace webview_plugin::benchmark
@@ -0,0 +1,113 @@
+#include "BenchmarkHarness.h"
+#include <iostream>
+#include <vector>
+
+namespace webview_plugin::benchmark {
+namespace {
+std::vector<Configuration> createConfigurations(const Options& options) {
+  std::vector<Configuration> configurations;
+
+  for (const auto numChannels : options.channelCounts) {
+    for (const auto sampleRate : options.sampleRates) {
+      for (const auto blockSize : options.blockSizes) {
+        for (const auto numHarmonics : options.harmonicCounts) {
+          // When bypassed, the shaper settings make no difference
+          configurations.push_back({.numChannels = numChannels,
+                                    .sampleRate = sampleRate,
+                                    .blockSize = blockSize,
+                                    .bypass = true,
+                                    .numHarmonics = numHarmonics});
+
+          const auto addShaper = [&](int distortionType,
+                                     bool harmonicExciter) {
+            for (const auto oversamplingFactor : options.oversamplingFactors) {
+              configurations.push_back(
+                  {.numChannels = numChannels,
+                   .sampleRate = sampleRate,
+                   .blockSize = blockSize,
+                   .distortionType = distortionType,
+                   .harmonicExciter = harmonicExciter,
+                   .oversamplingFactor = oversamplingFactor,
+                   .numHarmonics = numHarmonics});
+            }
+          };
+
+          for (auto distortionType = 0; distortionType < NUM_DISTORTION_TYPES;
+               ++distortionType) {
+            addShaper(distortionType, false);
+          }
+          // The exciter replaces the distortion type's curve
+          addShaper(0, true);
+        }
+      }
+    }
+  }
+
+  return configurations;
+}
+
+// The distortion type's name, or the exciter's if it replaces it
+juce::String getShaperName(const Configuration& configuration,
+                           const juce::StringArray& distortionTypeNames) {
+  return configuration.harmonicExciter
+             ? juce::String{"harmonic exciter"}
+             : distortionTypeNames[configuration.distortionType];
+}
+
+juce::var toVar(const Configuration& configuration,
+                const Result& result,
+                const juce::StringArray& distortionTypeNames) {
+  juce::DynamicObject::Ptr object{new juce::DynamicObject{}};
+  object->setProperty("channels", configuration.numChannels);
+  object->setProperty("sampleRate", configuration.sampleRate);
+  object->setProperty("blockSize", configuration.blockSize);
+  object->setProperty("distortionType",
+                      getShaperName(configuration, distortionTypeNames));
+  object->setProperty("oversampling", configuration.oversamplingFactor);
+  object->setProperty("bypass", configuration.bypass);
+  object->setProperty("harmonics", configuration.numHarmonics);
+  object->setProperty("nsPerSample", result.nanosecondsPerSample);
+  object->setProperty("nsPerChannelSample",
+                      result.nanosecondsPerChannelSample);
+  object->setProperty("realtimeFactor", result.realtimeFactor);
+  object->setProperty("p50BlockUs", result.p50BlockMicroseconds);
+  object->setProperty("p99BlockUs", result.p99BlockMicroseconds);
+  object->setProperty("maxBlockUs", result.maxBlockMicroseconds);
+  object->setProperty("latencySamples", result.latencySamples);
+  object->setProperty("midiCapacityOverflows",
+                      static_cast<int>(result.midiCapacityOverflows));
+  return juce::var{object.get()};
+}
+}  // namespace
+
+juce::var runRenderBenchmark(const Options& options) {
+  const auto configurations = createConfigurations(options);
+  const auto distortionTypeNames =
+      AudioPluginAudioProcessor{}.getDistortionTypeParameter().choices;
+
+  juce::Array<juce::var> results;
+  for (const auto& configuration : configurations) {
+    const auto result = run(configuration, options);
+    results.add(toVar(configuration, result, distortionTypeNames));
+
+    std::cerr << configuration.numChannels << " channels, "
+              << configuration.sampleRate << " Hz, " << configuration.blockSize
+              << " samples, "
+              << (configuration.bypass
+                      ? juce::String{"bypass"}
+                      : getShaperName(configuration, distortionTypeNames) +
+                            " " +
+                            juce::String{configuration.oversamplingFactor} +
+                            "x")
+              << ", " << configuration.numHarmonics
+              << " harmonics: " << result.nanosecondsPerSample
+              << " ns/sample, " << result.realtimeFactor << "x realtime"
+              << std::endl;
+  }
+
+  juce::DynamicObject::Ptr report{new juce::DynamicObject{}};
+  report->setProperty("secondsPerRun", options.secondsPerRun);
+  report->setProperty("results", results);
+  return juce::var{report.get()};
+}
+}  // namespace webview_plugin::benchmark
@@ -0,0 +1,174 @@
+#include "BenchmarkHarness.h"
+#include "JuceWebViewTutorial/ParameterIDs.hpp"
+#include <algorithm>
+#include <iostream>
+#include <memory>
+#include <vector>
+
+namespace webview_plugin::benchmark {
+namespace {
+// What a plugin storing its state through the APVTS ValueTree would do: the
+// parameters plus the harmonic settings as properties, written as XML
+void getStateAsXml(AudioPluginAudioProcessor& processor,
+                   juce::MemoryBlock& destData) {
+  const auto harmonicState = processor.captureState();
+  auto tree = processor.getState().copyState();
+
+  juce::StringArray harmonics;
+  for (auto i = 0; i < harmonicState.harmonics.size; ++i) {
+    harmonics.add(juce::String{
+        harmonicState.harmonics.values[static_cast<size_t>(i)]});
+  }
+  tree.setProperty("harmonics", harmonics.joinIntoString(" "), nullptr);
+  tree.setProperty("rootNote", harmonicState.rootNote, nullptr);
+  tree.setProperty("harmonicEnabled", harmonicState.harmonicEnabled, nullptr);
+
+  const auto xml = tree.createXml();
+  juce::AudioProcessor::copyXmlToBinary(*xml, destData);
+}
+
+void setStateFromXml(AudioPluginAudioProcessor& processor,
+                     const juce::MemoryBlock& data) {
+  const auto xml = juce::AudioProcessor::getXmlFromBinary(
+      data.getData(), static_cast<int>(data.getSize()));
+  if (xml == nullptr)
+    return;
+
+  const auto tree = juce::ValueTree::fromXml(*xml);
+  juce::Array<float> harmonics;
+  for (const auto& token : juce::StringArray::fromTokens(
+           tree.getProperty("harmonics").toString(), " ", "")) {
+    harmonics.add(token.getFloatValue());
+  }
+
+  processor.getState().replaceState(tree);
+  processor.setHarmonicValues(harmonics);
+  processor.setRootNote(tree.getProperty("rootNote", 60));
+  processor.setHarmonicEnabled(tree.getProperty("harmonicEnabled", true));
+}
+
+bool operator==(const ProcessorState& lhs, const ProcessorState& rhs) {
+  return lhs.parameters == rhs.parameters &&
+         lhs.harmonics.size == rhs.harmonics.size &&
+         lhs.harmonics.values == rhs.harmonics.values &&
+         lhs.rootNote == rhs.rootNote &&
+         lhs.harmonicEnabled == rhs.harmonicEnabled;
+}
+
+// Saves and then loads the state of every instance, like a host does with a
+// session
+template <typename Save, typename Load>
+juce::var measureSessions(
+    const std::vector<std::unique_ptr<AudioPluginAudioProcessor>>& instances,
+    int repetitions,
+    Save&& save,
+    Load&& load) {
+  std::vector<juce::MemoryBlock> states(instances.size());
+  std::vector<double> saveSeconds;
+  std::vector<double> loadSeconds;
+
+  // The states to compare the loaded ones with
+  std::vector<ProcessorState> expected;
+  for (const auto& instance : instances) {
+    expected.push_back(instance->captureState());
+  }
+
+  for (auto i = 0; i < repetitions; ++i) {
+    const auto start = juce::Time::getHighResolutionTicks();
+    for (size_t instance = 0; instance < instances.size(); ++instance) {
+      states[instance].reset();
+      save(*instances[instance], states[instance]);
+    }
+    const auto saved = juce::Time::getHighResolutionTicks();
+    for (size_t instance = 0; instance < instances.size(); ++instance) {
+      load(*instances[instance], states[instance]);
+    }
+    const auto end = juce::Time::getHighResolutionTicks();
+
+    saveSeconds.push_back(
+        juce::Time::highResolutionTicksToSeconds(saved - start));
+    loadSeconds.push_back(
+        juce::Time::highResolutionTicksToSeconds(end - saved));
+  }
+
+  size_t totalBytes = 0;
+  auto numMismatches = 0;
+  for (size_t instance = 0; instance < instances.size(); ++instance) {
+    totalBytes += states[instance].getSize();
+    if (!(instances[instance]->captureState() == expected[instance]))
+      ++numMismatches;
+  }
+
+  std::sort(saveSeconds.begin(), saveSeconds.end());
+  std::sort(loadSeconds.begin(), loadSeconds.end());
+  juce::DynamicObject::Ptr result{new juce::DynamicObject{}};
+  result->setProperty("p50SaveUs", 1e6 * getPercentile(saveSeconds, 0.5));
+  result->setProperty("p50LoadUs", 1e6 * getPercentile(loadSeconds, 0.5));
+  result->setProperty("maxSaveUs", 1e6 * saveSeconds.back());
+  result->setProperty("maxLoadUs", 1e6 * loadSeconds.back());
+  result->setProperty("bytesPerInstance",
+                      static_cast<juce::int64>(totalBytes / instances.size()));
+  result->setProperty("roundTripMismatches", numMismatches);
+  return juce::var{result.get()};
+}
+}  // namespace
+
+juce::var runStateBenchmark(const Options& options) {
+  // Every instance gets a different state
+  juce::Random random{42};
+  std::vector<std::unique_ptr<AudioPluginAudioProcessor>> instances;
+  for (auto i = 0; i < options.instances; ++i) {
+    auto& processor =
+        *instances.emplace_back(std::make_unique<AudioPluginAudioProcessor>());
+    setParameter(processor, id::GAIN, random.nextFloat());
+    setParameter(processor, id::PAN, random.nextFloat());
+    setParameter(processor, id::DISTORTION_TYPE,
+                 static_cast<float>(random.nextInt(NUM_DISTORTION_TYPES)));
+    setParameter(processor, id::HARMONIC_EXCITER,
+                 random.nextBool() ? 1.f : 0.f);
+    setParameter(processor, id::OVERSAMPLING,
+                 static_cast<float>(random.nextInt(4)));
+
+    juce::Array<float> harmonics;
+    for (auto harmonic = 0; harmonic < HarmonicTable::MAX_HARMONICS;
+         ++harmonic) {
+      harmonics.add(static_cast<float>(5 * random.nextInt(21)));
+    }
+    processor.setHarmonicValues(harmonics);
+    processor.setRootNote(36 + random.nextInt(48));
+    processor.setHarmonicEnabled(random.nextBool());
+  }
+
+  const auto binary = measureSessions(
+      instances, options.repetitions,
+      [](auto& processor, auto& data) { processor.getStateInformation(data); },
+      [](auto& processor, const auto& data) {
+        processor.setStateInformation(data.getData(),
+                                      static_cast<int>(data.getSize()));
+      });
+  const auto xml = measureSessions(instances, options.repetitions,
+                                   getStateAsXml, setStateFromXml);
+
+  juce::DynamicObject::Ptr report{new juce::DynamicObject{}};
+  report->setProperty("instances", options.instances);
+  report->setProperty("repetitions", options.repetitions);
+  report->setProperty("binary", binary);
+  report->setProperty("valueTreeXml", xml);
+
+  std::cerr << options.instances << " instances, p50 save/load per session:"
+            << " binary " << binary["p50SaveUs"].toString() << "/"
+            << binary["p50LoadUs"].toString() << " us, "
+            << binary["bytesPerInstance"].toString() << " bytes each; XML "
+            << xml["p50SaveUs"].toString() << "/"
+            << xml["p50LoadUs"].toString() << " us, "
+            << xml["bytesPerInstance"].toString() << " bytes each"
+            << std::endl;
+
+  return juce::var{report.get()};
+}
+
+bool passesStateChecks(const juce::var& report) {
+  return static_cast<int>(report["binary"]["roundTripMismatches"]) == 0 &&
+         static_cast<int>(report["valueTreeXml"]["roundTripMismatches"]) == 0;
+}
+}  // namespace webview_plugin::benchmark
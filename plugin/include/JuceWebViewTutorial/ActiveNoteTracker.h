@@ -0,0 +1,151 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "JuceWebViewTutorial/HarmonicTable.h"
+
+namespace webview_plugin {
+
+/**
+ * @brief Fixed-capacity bookkeeping of held notes and their harmonics.
+ *
+ * Every (channel, note) pair owns one preallocated slot holding the harmonic
+ * notes voiced for it, so note-offs are O(1) and nothing is allocated after
+ * prepare(). Additionally, every output note carries a reference count: when
+ * two held notes share a harmonic (or a harmonic coincides with a held root
+ * note), the note-off is only emitted once the last of them is released.
+ */
+class ActiveNoteTracker {
+public:
+  static constexpr int NUM_CHANNELS = 16;
+  static constexpr int NUM_NOTES = 128;
+
+  /** Allocates the slots. Call off the audio thread, e.g., in prepareToPlay.
+   */
+  void prepare();
+
+  /** Forgets all held notes without emitting anything. */
+  void reset() noexcept;
+
+  [[nodiscard]] bool isPrepared() const noexcept { return !slots.empty(); }
+
+  /**
+   * @brief Registers a note-on of a root note.
+   *
+   * If the root note is already held on this channel, the harmonics of the
+   * previous note-on are released first and the note is re-voiced: the root
+   * keeps its single reference, so the next note-off still releases it.
+   *
+   * @param emitNoteOff called with the note number of every harmonic whose
+   * last reference was released
+   */
+  template <typename EmitNoteOff>
+  void startNote(int channel, int rootNote, EmitNoteOff&& emitNoteOff) {
+    if (!isPrepared())
+      return;
+
+    const auto retriggered = getSlot(channel, rootNote).active;
+    releaseHarmonics(channel, rootNote, emitNoteOff);
+
+    if (!retriggered)
+      ++referenceCount(channel, rootNote);
+
+    getSlot(channel, rootNote).active = true;
+  }
+
+  /** Registers a harmonic voiced for a held root note. */
+  void addHarmonic(int channel, int rootNote, int harmonicNote) noexcept;
+
+  /**
+   * @brief Registers a note-off of a root note.
+   *
+   * @return true if the note-off should be forwarded, i.e., no other held
+   * note still references this note number on this channel
+   */
+  [[nodiscard]] bool releaseRoot(int channel, int rootNote) noexcept;
+
+  /**
+   * @brief Releases the harmonics voiced for a root note.
+   *
+   * @param emitNoteOff called with the note number of every harmonic whose
+   * last reference was released
+   */
+  template <typename EmitNoteOff>
+  void releaseHarmonics(int channel, int rootNote, EmitNoteOff&& emitNoteOff) {
+    if (!isPrepared())
+      return;
+
+    auto& slot = getSlot(channel, rootNote);
+    if (!slot.active)
+      return;
+
+    for (auto i = 0u; i < slot.numHarmonics; ++i) {
+      const auto harmonicNote = static_cast<int>(slot.harmonics[i]);
+      if (release(channel, harmonicNote))
+        emitNoteOff(harmonicNote);
+    }
+
+    slot.numHarmonics = 0;
+    slot.active = false;
+  }
+
+  /**
+   * @brief Releases the harmonics of every held root note and forgets all
+   * notes.
+   *
+   * Roots are not released: the player still holds them.
+   *
+   * @param emitNoteOff called with the channel and note number of every
+   * harmonic whose last reference was released
+   */
+  template <typename EmitNoteOff>
+  void releaseAll(EmitNoteOff&& emitNoteOff) {
+    if (!isPrepared())
+      return;
+
+    for (auto channel = 1; channel <= NUM_CHANNELS; ++channel) {
+      for (auto note = 0; note < NUM_NOTES; ++note) {
+        releaseHarmonics(channel, note, [&](int harmonicNote) {
+          emitNoteOff(channel, harmonicNote);
+        });
+      }
+    }
+
+    reset();
+  }
+
+  /** Forgets all notes held on a channel, e.g., on an all-notes-off message.
+   */
+  void resetChannel(int channel) noexcept;
+
+  /** Number of output notes currently sounding on all channels. */
+  [[nodiscard]] int getNumSoundingNotes() const noexcept;
+
+private:
+  struct Slot {
+    std::array<std::uint8_t, HarmonicTable::MAX_HARMONICS> harmonics{};
+    std::uint8_t numHarmonics = 0;
+    bool active = false;
+  };
+
+  static std::size_t indexOf(int channel, int note) noexcept {
+    // MIDI channels are 1-based
+    return static_cast<std::size_t>((channel - 1) * NUM_NOTES + note);
+  }
+
+  Slot& getSlot(int channel, int note) noexcept {
+    return slots[indexOf(channel, note)];
+  }
+
+  std::uint16_t& referenceCount(int channel, int note) noexcept {
+    return referenceCounts[indexOf(channel, note)];
+  }
+
+  bool release(int channel, int note) noexcept;
+
+  std::vector<Slot> slots;
+  std::vector<std::uint16_t> referenceCounts;
+};
+}  // namespace webview_plugin
@@ -0,0 +1,132 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <vector>
+#include <juce_dsp/juce_dsp.h>
+#include "JuceWebViewTutorial/HarmonicTable.h"
+
+namespace webview_plugin {
+
+/**
+ * @brief Precompiled amplitudes of the partials to render for every note.
+ *
+ * Compiled from a HarmonicTable without allocating, along with the
+ * VoicingPlan. Inaudible harmonics are dropped and the remaining ones are
+ * listed by ascending harmonic number, so the audio thread may stop at the
+ * first partial above the Nyquist frequency.
+ */
+struct PartialPlan {
+  struct Partial {
+    /** 1 for the fundamental, n for the n-th harmonic. */
+    int harmonic = 1;
+    float amplitude = 0.f;
+  };
+
+  std::array<Partial, HarmonicTable::MAX_HARMONICS> partials{};
+  int size = 0;
+  /** Amplitude of every harmonic, audible or not, indexed by harmonic - 1. */
+  std::array<float, HarmonicTable::MAX_HARMONICS> amplitudes{};
+
+  /** Harmonics at or below this normalized amplitude are not rendered. */
+  static constexpr float AUDIBILITY_THRESHOLD = 0.01f;
+
+  [[nodiscard]] static PartialPlan compile(const HarmonicTable& table);
+};
+
+/**
+ * @brief Polyphonic additive synthesizer rendering the harmonic table as
+ * exact integer-ratio sines.
+ *
+ * Every partial is a recursive quadrature oscillator: a unit phasor rotated
+ * by a fixed complex factor each sample. This needs no table lookups, so the
+ * inner loop over a voice's partials is branch-free multiply-adds over
+ * struct-of-arrays storage that compilers vectorize. Partial counts are
+ * padded to whole SIMD lanes with silent partials. The phasors are
+ * renormalized once per render call to stop their magnitude from drifting.
+ *
+ * All voices are allocated in prepare(). When all of them are in use, a new
+ * note steals the oldest released voice, or the oldest voice if none is
+ * released. Partials at or above the Nyquist frequency are culled per voice
+ * at note-on. A new plan ramps the amplitudes of held voices over the next
+ * render call; harmonics that become audible only sound from the next note.
+ */
+class AdditiveSynth {
+public:
+  static constexpr int MAX_VOICES = 64;
+  static constexpr int MAX_PARTIALS = HarmonicTable::MAX_HARMONICS;
+  static constexpr int LANES = 8;
+  static constexpr auto ATTACK_SECONDS = 0.005;
+  static constexpr auto RELEASE_SECONDS = 0.05;
+  /** Keeps a single voice of a fully voiced table below full scale. */
+  static constexpr auto OUTPUT_GAIN = 0.25f;
+
+  static_assert(MAX_PARTIALS % LANES == 0);
+
+  /** Allocates all voices and the mono scratch buffer. Call off the audio
+   * thread. */
+  void prepare(double sampleRate, int maxBlockSize);
+
+  /** Silences all voices immediately. */
+  void reset() noexcept;
+
+  /** Audio thread: used by voices started from now on, and ramped to by held
+   * ones. */
+  void setPlan(const PartialPlan& newPlan) noexcept;
+
+  /** Audio thread: starts and releases voices. */
+  void handleMidiEvent(const juce::MidiMessage& message) noexcept;
+
+  /** Audio thread: adds the voices' output to every channel of the block. */
+  void render(juce::dsp::AudioBlock<float> block) noexcept;
+
+  /** Audio thread: adds the voices' output to a mono buffer. */
+  void render(float* output, int numSamples) noexcept;
+
+  [[nodiscard]] int getNumActiveVoices() const noexcept;
+
+  /** Partials rendered by all active voices, without padding. */
+  [[nodiscard]] int getNumActivePartials() const noexcept;
+
+private:
+  enum class Stage : std::uint8_t { idle, attack, sustain, release };
+
+  void startVoice(int note, float velocity) noexcept;
+  void releaseVoices(int note) noexcept;
+  void releaseAllVoices() noexcept;
+  [[nodiscard]] int findVoiceToStart() const noexcept;
+  void startRamp(size_t voice, float target, double seconds) noexcept;
+  void renderVoice(size_t voice, float* output, int numSamples) noexcept;
+
+  [[nodiscard]] size_t getPartialOffset(size_t voice) const noexcept {
+    return voice * MAX_PARTIALS;
+  }
+
+  double sampleRate = 44100.0;
+  PartialPlan plan;
+  std::uint32_t voiceCounter = 0;
+
+  // Per voice
+  std::array<Stage, MAX_VOICES> stages{};
+  std::array<int, MAX_VOICES> notes{};
+  std::array<float, MAX_VOICES> velocities{};
+  std::array<std::uint32_t, MAX_VOICES> startOrder{};
+  std::array<float, MAX_VOICES> gains{};
+  std::array<float, MAX_VOICES> gainSteps{};
+  std::array<int, MAX_VOICES> rampSamplesLeft{};
+  std::array<int, MAX_VOICES> numPartials{};
+  std::array<int, MAX_VOICES> numPaddedPartials{};
+  std::array<bool, MAX_VOICES> amplitudeRampPending{};
+
+  // Per partial, MAX_PARTIALS per voice
+  std::vector<float> real;
+  std::vector<float> imaginary;
+  std::vector<float> cosines;
+  std::vector<float> sines;
+  std::vector<float> amplitudes;
+  std::vector<float> amplitudeSteps;
+  std::vector<std::uint8_t> harmonics;
+
+  std::vector<float> scratch;
+};
+}  // namespace webview_plugin
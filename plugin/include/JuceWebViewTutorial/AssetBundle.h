@@ -0,0 +1,100 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <juce_core/juce_core.h>
+
+/**
+ * Binary format of the web UI files packed at build time.
+ *
+ * All integers are little-endian. The bundle consists of
+ *   - a 16-byte header: magic "WVAB", format version, number of entries and a
+ *     reserved word,
+ *   - the manifest: one fixed-size record per file, sorted by path hash,
+ *   - a string table with the paths and MIME types,
+ *   - the file contents, each starting at a 16-byte boundary.
+ *
+ * Files are either stored as-is, so that they can be served straight from the
+ * binary data, or compressed with zlib when that pays off (large JS bundles).
+ */
+namespace webview_plugin::asset_bundle {
+inline constexpr std::array<char, 4> MAGIC{'W', 'V', 'A', 'B'};
+inline constexpr std::uint32_t VERSION = 1;
+inline constexpr size_t HEADER_SIZE = 16;
+inline constexpr size_t MANIFEST_ENTRY_SIZE = 48;
+inline constexpr size_t DATA_ALIGNMENT = 16;
+
+enum class Codec : std::uint32_t { stored = 0, zlib = 1 };
+
+struct ManifestEntry {
+  std::uint64_t pathHash = 0;
+  /** Hash of the uncompressed contents. */
+  std::uint64_t contentHash = 0;
+  std::uint32_t pathOffset = 0;
+  std::uint32_t pathLength = 0;
+  std::uint32_t mimeTypeOffset = 0;
+  std::uint32_t mimeTypeLength = 0;
+  std::uint32_t dataOffset = 0;
+  /** Size of the data in the bundle. */
+  std::uint32_t storedSize = 0;
+  /** Size of the uncompressed contents. */
+  std::uint32_t size = 0;
+  Codec codec = Codec::stored;
+};
+
+/** 64-bit FNV-1a hash. */
+[[nodiscard]] constexpr std::uint64_t hash(const char* data,
+                                           size_t size) noexcept {
+  std::uint64_t result = 14695981039346656037ull;
+  for (size_t i = 0; i < size; ++i) {
+    result ^= static_cast<unsigned char>(data[i]);
+    result *= 1099511628211ull;
+  }
+  return result;
+}
+
+[[nodiscard]] inline std::uint64_t hashPath(const juce::String& path) noexcept {
+  return hash(path.toRawUTF8(), path.getNumBytesAsUTF8());
+}
+
+struct PackOptions {
+  /** Smaller files are always stored. */
+  size_t minCompressedSize = 4096;
+  /** Compressed files must be at most this fraction of the original size. */
+  double maxCompressionRatio = 0.9;
+  /** File name wildcards of files left out of the bundle. */
+  juce::StringArray excludedFiles{"*.LICENSE.txt", ".*"};
+};
+
+struct PackStatistics {
+  int numFiles = 0;
+  int numCompressedFiles = 0;
+  int numExcludedFiles = 0;
+  size_t inputBytes = 0;
+  size_t bundleBytes = 0;
+};
+
+/**
+ * @brief Writes a bundle of all files in directory and its subdirectories.
+ *
+ * Paths in the bundle are relative to directory, e.g., "js/index.js".
+ */
+juce::Result pack(const juce::File& directory,
+                  juce::OutputStream& output,
+                  PackStatistics& statistics,
+                  const PackOptions& options = {});
+
+/**
+ * @brief Reads the manifest of a bundle.
+ *
+ * @return the manifest entries, in bundle order, or an error if the bundle
+ * is malformed
+ */
+juce::Result readManifest(const void* bundle,
+                          size_t bundleSize,
+                          std::vector<ManifestEntry>& entries);
+
+[[nodiscard]] const char* getMimeForExtension(const juce::String& extension);
+}  // namespace webview_plugin::asset_bundle
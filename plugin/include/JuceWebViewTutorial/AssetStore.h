@@ -0,0 +1,66 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <vector>
+#include <juce_core/juce_core.h>
+#include "JuceWebViewTutorial/AssetBundle.h"
+
+namespace webview_plugin {
+
+/**
+ * @brief Read-only store of the web UI files packed into an asset bundle.
+ *
+ * Files are looked up by binary search over the bundle's manifest, which is
+ * sorted by path hash. Stored files are served straight from the bundle's
+ * memory. Compressed files are inflated on their first request and cached, so
+ * later requests don't touch the compressed data again. All member functions
+ * are thread-safe, so a single store can serve every editor of the process.
+ *
+ * @see asset_bundle::pack()
+ */
+class AssetStore {
+public:
+  struct Asset {
+    /** Valid for the lifetime of the store. */
+    std::span<const std::byte> bytes;
+    juce::String mimeType;
+    std::uint64_t contentHash = 0;
+  };
+
+  /** @param bundleData must outlive the store, e.g., binary data */
+  AssetStore(const void* bundleData, size_t bundleSize);
+
+  /**
+   * @brief Get a web UI file
+   *
+   * @param path path of the form "index.html", "js/index.js", etc.
+   * @return the file's bytes and MIME type or std::nullopt if the file is not
+   * contained in the bundle
+   */
+  [[nodiscard]] std::optional<Asset> get(const juce::String& path) const;
+
+  [[nodiscard]] juce::StringArray getPaths() const;
+
+private:
+  [[nodiscard]] std::span<const std::byte> getStoredBytes(
+      const asset_bundle::ManifestEntry& entry) const noexcept;
+  [[nodiscard]] juce::String getString(std::uint32_t offset,
+                                       std::uint32_t length) const;
+  [[nodiscard]] std::span<const std::byte> getInflatedBytes(
+      size_t entryIndex) const;
+
+  const std::byte* bundle;
+  size_t bundleSize;
+  std::vector<asset_bundle::ManifestEntry> manifest;
+  juce::StringArray mimeTypes;
+  // Per manifest entry, filled on the first request of compressed files
+  mutable std::vector<std::unique_ptr<const std::vector<std::byte>>> inflated;
+  mutable std::mutex inflatedLock;
+
+  JUCE_DECLARE_NON_COPYABLE(AssetStore)
+};
+}  // namespace webview_plugin
@@ -0,0 +1,156 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <juce_core/juce_core.h>
+
+// Set to 0 to compile all profiling probes out
+#ifndef WEBVIEW_PLUGIN_ENABLE_PROFILER
+#define WEBVIEW_PLUGIN_ENABLE_PROFILER 1
+#endif
+
+namespace webview_plugin {
+
+/**
+ * Parts of the processing that are timed separately. Stages nest like the
+ * code they time: block contains the others, distortion contains additive.
+ */
+enum class ProfilerStage : std::uint8_t {
+  /** The whole processBlock() call. */
+  block,
+  harmonicMidi,
+  /** The sub-block loop: additive, shaper, oversampling, gain and pan. */
+  distortion,
+  /** The internal additive engine's oscillators, per sub-block. */
+  additive,
+  metering,
+  /** One FFT frame of the spectrum analyzer, on its worker thread. */
+  spectrum,
+  numStages
+};
+
+[[nodiscard]] const char* getStageName(ProfilerStage stage) noexcept;
+
+/** Duration of one stage in one block. */
+struct ProfileRecord {
+  juce::int64 ticks = 0;
+  int numSamples = 0;
+  ProfilerStage stage = ProfilerStage::block;
+};
+
+/**
+ * @brief Lock-free single-producer/single-consumer ring of profile records.
+ *
+ * The producer (the audio thread) never blocks or allocates: when the ring
+ * is full, the record is dropped and counted instead.
+ */
+class ProfilerRing {
+public:
+  static constexpr int CAPACITY = 4096;
+
+  void push(const ProfileRecord& record) noexcept {
+    const auto scope = fifo.write(1);
+    if (scope.blockSize1 + scope.blockSize2 == 0) {
+      numDropped.fetch_add(1, std::memory_order_relaxed);
+      return;
+    }
+    scope.forEach([this, &record](int index) {
+      records[static_cast<size_t>(index)] = record;
+    });
+  }
+
+  /** Consumer side: calls consumer with every record pushed so far. */
+  template <typename Consumer>
+  void drain(Consumer&& consumer) {
+    const auto scope = fifo.read(fifo.getNumReady());
+    scope.forEach([this, &consumer](int index) {
+      consumer(records[static_cast<size_t>(index)]);
+    });
+  }
+
+  [[nodiscard]] std::uint32_t getNumDropped() const noexcept {
+    return numDropped.load(std::memory_order_relaxed);
+  }
+
+private:
+  juce::AbstractFifo fifo{CAPACITY};
+  std::array<ProfileRecord, CAPACITY> records{};
+  std::atomic<std::uint32_t> numDropped{0};
+};
+
+/** Times its own lifetime and pushes the result into a ring. */
+class ScopedProfile {
+public:
+  ScopedProfile(ProfilerRing& ringToUse,
+                ProfilerStage stageToTime,
+                int numSamplesProcessed) noexcept
+      : ring{ringToUse},
+        stage{stageToTime},
+        numSamples{numSamplesProcessed},
+        start{juce::Time::getHighResolutionTicks()} {}
+
+  ~ScopedProfile() noexcept {
+    ring.push({.ticks = juce::Time::getHighResolutionTicks() - start,
+               .numSamples = numSamples,
+               .stage = stage});
+  }
+
+private:
+  ProfilerRing& ring;
+  ProfilerStage stage;
+  int numSamples;
+  juce::int64 start;
+
+  JUCE_DECLARE_NON_COPYABLE(ScopedProfile)
+};
+
+/**
+ * @brief Aggregates profile records into per-stage statistics.
+ *
+ * Message thread only. The time of each record is expressed as a share of the
+ * block's real-time budget (numSamples / sampleRate) and collected into a
+ * histogram.
+ */
+class ProfileStatistics {
+public:
+  /** Histogram bins cover 0-200% of the budget. */
+  static constexpr int NUM_BINS = 100;
+  static constexpr double MAX_BUDGET_SHARE = 2.0;
+
+  void add(const ProfileRecord& record, double sampleRate) noexcept;
+
+  void reset() noexcept;
+
+  /** Statistics of all stages as a JSON-compatible object. */
+  [[nodiscard]] juce::var toVar() const;
+
+private:
+  struct StageStatistics {
+    std::array<std::uint32_t, NUM_BINS + 1> histogram{};
+    std::uint64_t count = 0;
+    double totalSeconds = 0.0;
+    double maxSeconds = 0.0;
+    double totalBudgetShare = 0.0;
+    // Exponential moving average, follows recent load
+    double recentBudgetShare = 0.0;
+  };
+
+  [[nodiscard]] static double getPercentile(const StageStatistics& statistics,
+                                            double percentile) noexcept;
+
+  std::array<StageStatistics, static_cast<size_t>(ProfilerStage::numStages)>
+      stages;
+};
+}  // namespace webview_plugin
+
+#if WEBVIEW_PLUGIN_ENABLE_PROFILER
+/** Times the enclosing scope as the given stage. */
+#define WEBVIEW_PROFILE_SCOPE(ring, stage, numSamples)                     \
+  const webview_plugin::ScopedProfile JUCE_JOIN_MACRO(profileScope_,       \
+                                                      __LINE__) {          \
+    ring, stage, numSamples                                                \
+  }
+#else
+#define WEBVIEW_PROFILE_SCOPE(ring, stage, numSamples)
+#endif
@@ -0,0 +1,123 @@
+#pragma once
+
+#include <algorithm>
+#include <vector>
+#include <juce_dsp/juce_dsp.h>
+
+namespace webview_plugin {
+
+/**
+ * @brief Switches between the processed and the unprocessed signal with a
+ * short linear crossfade instead of a jump.
+ *
+ * Outside of a crossfade, the processing either runs in place or not at all.
+ * During a crossfade, the input is copied to a buffer allocated in prepare()
+ * and mixed with the processed signal.
+ *
+ * The unprocessed signal goes through a delay line matching the latency of
+ * the processing, see setDryDelay(), so that both are aligned during a
+ * crossfade and the bypassed output is as late as the host expects. The delay
+ * line is fed all the time, also while nothing is delayed, so that it's
+ * filled when the latency changes.
+ */
+class BypassCrossfade {
+public:
+  static constexpr auto FADE_LENGTH_SECONDS = 0.01;
+
+  /**
+   * Allocates the dry buffer and the dry delay line, which holds up to
+   * maxDryDelay samples. Call off the audio thread.
+   */
+  void prepare(double sampleRate,
+               int numChannels,
+               int maxBlockSize,
+               int maxDryDelay);
+
+  /** Latency of processWet in samples, at most the prepared maxDryDelay. */
+  void setDryDelay(int numSamples) noexcept {
+    dryDelay = juce::jlimit(0, delayLine.getNumSamples() - 1, numSamples);
+  }
+
+  /** Jumps to the given state without crossfading. */
+  void reset(bool bypassed) noexcept {
+    wetMix.setCurrentAndTargetValue(bypassed ? 0.f : 1.f);
+  }
+
+  /** Starts crossfading towards the given state. */
+  void setBypassed(bool bypassed) noexcept {
+    wetMix.setTargetValue(bypassed ? 0.f : 1.f);
+  }
+
+  /** Whether process() skips processWet, outside of a crossfade. */
+  [[nodiscard]] bool isFullyBypassed() const noexcept {
+    return !wetMix.isSmoothing() && wetMix.getTargetValue() <= 0.f;
+  }
+
+  /**
+   * @brief Calls processWet with the block (or parts of it) unless fully
+   * bypassed, and crossfades the result with the input if needed.
+   */
+  template <typename ProcessWet>
+  void process(juce::dsp::AudioBlock<float> block, ProcessWet&& processWet) {
+    if (!wetMix.isSmoothing()) {
+      if (wetMix.getTargetValue() > 0.f) {
+        pushDry(block);
+        processWet(block);
+      } else {
+        delayDry(block, block);
+      }
+      return;
+    }
+
+    // Crossfades are computed in chunks that fit the dry buffer
+    const auto maxChunkSize = mixRamp.size();
+    for (size_t start = 0; start < block.getNumSamples();
+         start += maxChunkSize) {
+      processCrossfading(
+          block.getSubBlock(
+              start, std::min(maxChunkSize, block.getNumSamples() - start)),
+          processWet);
+    }
+  }
+
+private:
+  template <typename ProcessWet>
+  void processCrossfading(juce::dsp::AudioBlock<float> block,
+                          ProcessWet& processWet) {
+    const auto numSamples = block.getNumSamples();
+    auto dry = juce::dsp::AudioBlock<float>{dryBuffer}
+                   .getSubsetChannelBlock(0u, block.getNumChannels())
+                   .getSubBlock(0u, numSamples);
+    delayDry(block, dry);
+
+    processWet(block);
+
+    for (auto i = 0u; i < numSamples; ++i) {
+      mixRamp[i] = wetMix.getNextValue();
+    }
+
+    for (auto channel = 0u; channel < block.getNumChannels(); ++channel) {
+      auto* samples = block.getChannelPointer(channel);
+      const auto* drySamples = dry.getChannelPointer(channel);
+      for (auto i = 0u; i < numSamples; ++i) {
+        samples[i] = drySamples[i] + mixRamp[i] * (samples[i] - drySamples[i]);
+      }
+    }
+  }
+
+  // Feeds the input into the delay line
+  void pushDry(juce::dsp::AudioBlock<const float> input) noexcept;
+  // Feeds the input into the delay line and writes the input of dryDelay
+  // samples ago into output, which may be the input itself
+  void delayDry(juce::dsp::AudioBlock<const float> input,
+                juce::dsp::AudioBlock<float> output) noexcept;
+
+  juce::SmoothedValue<float> wetMix{1.f};
+  juce::AudioBuffer<float> dryBuffer;
+  std::vector<float> mixRamp;
+  // Circular, with one sample more than the longest delay
+  juce::AudioBuffer<float> delayLine;
+  int delayWritePosition = 0;
+  int dryDelay = 0;
+};
+}  // namespace webview_plugin
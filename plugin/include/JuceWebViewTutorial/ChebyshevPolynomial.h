@@ -0,0 +1,65 @@
+#pragma once
+
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include "JuceWebViewTutorial/HarmonicTable.h"
+
+namespace webview_plugin {
+
+/**
+ * @brief Sum of Chebyshev polynomials that turns a full-scale sine into the
+ * harmonic spectrum of a HarmonicTable.
+ *
+ * Since T_n(cos t) = cos(n t), the n-th harmonic of the table becomes the
+ * coefficient of T_n. Compiled without allocating, along with the
+ * VoicingPlan. The coefficients are scaled so that the output stays within
+ * +/-1 and offset so that silence maps to silence. Tables with even
+ * harmonics therefore add a DC offset to loud input, like any asymmetric
+ * shaper.
+ *
+ * Evaluated with the Clenshaw recurrence, i.e., two multiply-adds per
+ * degree. The input is clamped to [-1, 1], where the polynomial is bounded.
+ */
+struct ChebyshevPolynomial {
+  static constexpr int MAX_DEGREE = HarmonicTable::MAX_HARMONICS;
+
+  /** Coefficient of T_k at index k. */
+  std::array<float, MAX_DEGREE + 1> coefficients{};
+  /** Highest k with a nonzero coefficient, 0 for silence. */
+  int degree = 0;
+
+  [[nodiscard]] static ChebyshevPolynomial compile(const HarmonicTable& table);
+
+  /** Evaluates a single sample, e.g., fused into another per-sample loop. */
+  float operator()(float x) const noexcept {
+    x = clamp(x);
+    const auto twoX = 2.f * x;
+    auto b1 = 0.f;
+    auto b2 = 0.f;
+    for (auto k = degree; k > 0; --k) {
+      const auto b0 =
+          coefficients[static_cast<size_t>(k)] + twoX * b1 - b2;
+      b2 = b1;
+      b1 = b0;
+    }
+    return coefficients[0] + x * b1 - b2;
+  }
+
+  /**
+   * @brief Evaluates the polynomial in place over a buffer.
+   *
+   * The recurrence runs over chunks of samples with the degree loop outside,
+   * so that the inner loop is independent across samples and vectorizes.
+   */
+  void process(float* samples, size_t numSamples) const noexcept;
+
+private:
+  static constexpr size_t CHUNK_SIZE = 64;
+
+  // clamp(x, -1, 1) == (|x + 1| - |x - 1|) / 2, see RationalTanh
+  static float clamp(float x) noexcept {
+    return 0.5f * (std::abs(x + 1.f) - std::abs(x - 1.f));
+  }
+};
+}  // namespace webview_plugin
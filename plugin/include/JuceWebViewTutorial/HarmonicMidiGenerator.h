@@ -0,0 +1,76 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <juce_audio_basics/juce_audio_basics.h>
+#include "JuceWebViewTutorial/ActiveNoteTracker.h"
+#include "JuceWebViewTutorial/HarmonicVoicing.h"
+
+namespace webview_plugin {
+
+/**
+ * @brief Expands incoming note-ons into harmonic note-ons.
+ *
+ * Generated events are collected in scratch storage reserved in prepare() for
+ * the worst case of every input event being a fully voiced note-on. The
+ * scratch storage is then swapped into the host's buffer instead of copied, so
+ * a small host buffer never grows on the audio thread. The host's storage
+ * comes back in exchange: hosts reuse their buffer, so from the next block on
+ * it's the storage handed out before. A spare buffer of the same capacity
+ * takes the place of storage that is too small, so the audio thread does not
+ * allocate as long as the reservation holds. Blocks that allocate anyway are
+ * counted, see getNumCapacityOverflows().
+ */
+class HarmonicMidiGenerator {
+public:
+  static constexpr int DEFAULT_MAX_INPUT_EVENTS_PER_BLOCK = 128;
+
+  /** Allocates all storage. Call off the audio thread. */
+  void prepare(int maxInputEventsPerBlock = DEFAULT_MAX_INPUT_EVENTS_PER_BLOCK);
+
+  /** Forgets all held notes. */
+  void reset() noexcept;
+
+  /**
+   * @brief Replaces the contents of midiMessages with the original events
+   * plus the harmonics voiced according to plan.
+   */
+  void process(juce::MidiBuffer& midiMessages, const VoicingPlan& plan);
+
+  /**
+   * @brief Adds note-offs for the harmonics of all held notes at the start of
+   * midiMessages and forgets the notes, e.g., when the harmonics stop being
+   * sent as MIDI while notes are held.
+   */
+  void releaseAll(juce::MidiBuffer& midiMessages);
+
+  /**
+   * How many blocks needed more event storage than the scratch buffer had,
+   * because of more events than reserved for or a host that passed a new,
+   * small buffer while the spare was in use.
+   */
+  [[nodiscard]] std::uint32_t getNumCapacityOverflows() const noexcept {
+    return capacityOverflows.load(std::memory_order_relaxed);
+  }
+
+  [[nodiscard]] const ActiveNoteTracker& getActiveNotes() const noexcept {
+    return activeNotes;
+  }
+
+private:
+  void addEvent(const juce::MidiMessage& message, int samplePosition);
+  // Empties the scratch buffer, keeping its storage
+  void clearScratch() noexcept;
+  // Swaps the scratch events into the host's buffer, see the class comment
+  void swapScratchWith(juce::MidiBuffer& midiMessages) noexcept;
+
+  ActiveNoteTracker activeNotes;
+  juce::MidiBuffer scratch;
+  juce::MidiBuffer spare;
+  size_t reservedBytes = 0;
+  // Storage of the scratch buffer when the block started
+  size_t scratchCapacity = 0;
+  size_t usedBytes = 0;
+  std::atomic<std::uint32_t> capacityOverflows{0};
+};
+}  // namespace webview_plugin
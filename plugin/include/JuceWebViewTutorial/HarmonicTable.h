@@ -0,0 +1,20 @@
+#pragma once
+
+#include <array>
+
+namespace webview_plugin {
+
+/**
+ * @brief Fixed-capacity table of harmonic amplitudes.
+ *
+ * Index 0 is the fundamental, index n is the (n + 1)-th harmonic. Values are
+ * in the 0-100 range used by the web UI's harmonic editor. The table never
+ * allocates so that it can be copied between threads freely.
+ */
+struct HarmonicTable {
+  static constexpr int MAX_HARMONICS = 64;
+
+  std::array<float, MAX_HARMONICS> values{};
+  int size = 0;
+};
+}  // namespace webview_plugin
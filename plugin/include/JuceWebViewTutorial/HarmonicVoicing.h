@@ -0,0 +1,33 @@
+#pragma once
+
+#include <array>
+#include "JuceWebViewTutorial/HarmonicTable.h"
+
+namespace webview_plugin {
+
+/**
+ * @brief Precompiled list of harmonic notes to emit for every note-on.
+ *
+ * Compiled from a HarmonicTable without allocating: by the audio thread in
+ * updateHarmonics() once a harmonic parameter has changed, and for program
+ * snapshots when a bank loads. The fundamental and all inaudible harmonics
+ * are dropped, and each remaining harmonic is reduced to its semitone
+ * distance from the root note and its velocity scale. Voices are
+ * sorted by ascending semitone offset, so the audio thread may stop at the
+ * first voice that falls outside of the MIDI note range.
+ */
+struct VoicingPlan {
+  struct Voice {
+    int semitoneOffset = 0;
+    float velocityScale = 0.f;
+  };
+
+  std::array<Voice, HarmonicTable::MAX_HARMONICS> voices{};
+  int size = 0;
+
+  /** Harmonics at or below this normalized amplitude are not voiced. */
+  static constexpr float AUDIBILITY_THRESHOLD = 0.01f;
+
+  [[nodiscard]] static VoicingPlan compile(const HarmonicTable& table);
+};
+}  // namespace webview_plugin
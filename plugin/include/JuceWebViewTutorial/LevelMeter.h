@@ -0,0 +1,108 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <optional>
+#include <juce_dsp/juce_dsp.h>
+#include "JuceWebViewTutorial/LoudnessMeter.h"
+#include "JuceWebViewTutorial/TripleBuffer.h"
+#include "JuceWebViewTutorial/TruePeakDetector.h"
+
+namespace webview_plugin {
+
+/** Output levels: per channel as linear gains, loudness in LUFS. */
+struct MeterSnapshot {
+  static constexpr int MAX_CHANNELS = 16;
+
+  /** Highest peak envelope level since the previous snapshot was consumed. */
+  std::array<float, MAX_CHANNELS> peak{};
+  /** RMS of all samples since the previous snapshot was consumed. */
+  std::array<float, MAX_CHANNELS> rms{};
+  /** Highest 4x oversampled peak since the previous snapshot was consumed. */
+  std::array<float, MAX_CHANNELS> truePeak{};
+  float momentaryLoudness = LoudnessMeter::MIN_LOUDNESS;
+  float shortTermLoudness = LoudnessMeter::MIN_LOUDNESS;
+  int numChannels = 0;
+  /** LevelMeter::Meters that produced the levels; the others are 0. */
+  std::uint8_t enabledMeters = 0;
+};
+
+/**
+ * @brief Meters the output and hands the levels from the audio thread to the
+ * editor.
+ *
+ * Every meter works on whole blocks: the sample peak and the sum of squares
+ * are lane-parallel reductions that compilers vectorize, and the peak
+ * ballistics (the 200 ms attack and release of a peak envelope follower) are
+ * applied once per block rather than per sample. True peak and loudness are
+ * off by default; meters that are switched off are skipped entirely.
+ *
+ * Levels accumulate over blocks until the editor consumes them, so that no
+ * peak is missed however slowly the editor polls. The audio thread publishes
+ * the accumulated levels every block through a triple buffer and starts over
+ * once it sees that the editor has pulled a snapshot. Neither side locks or
+ * allocates.
+ */
+class LevelMeter {
+public:
+  /** Meters that can be switched on and off, combined as flags. */
+  enum Meters : std::uint8_t {
+    peak = 1 << 0,
+    rms = 1 << 1,
+    truePeak = 1 << 2,
+    loudness = 1 << 3,
+    allMeters = peak | rms | truePeak | loudness
+  };
+
+  static constexpr auto PEAK_ATTACK_SECONDS = 0.2;
+  static constexpr auto PEAK_RELEASE_SECONDS = 0.2;
+  static constexpr std::uint8_t DEFAULT_METERS = peak | rms;
+
+  /** Allocates the meters' state. Call off the audio thread. */
+  void prepare(double sampleRate,
+               const juce::AudioChannelSet& channelLayout,
+               int maxBlockSize);
+
+  /** Any thread: switches meters on and off, see Meters. */
+  void setEnabledMeters(std::uint8_t meters) noexcept {
+    enabledMeters.store(meters, std::memory_order_relaxed);
+  }
+
+  [[nodiscard]] std::uint8_t getEnabledMeters() const noexcept {
+    return enabledMeters.load(std::memory_order_relaxed);
+  }
+
+  /** Audio thread: meters a block of the output and publishes the levels. */
+  void process(const juce::dsp::AudioBlock<const float>& signal) noexcept;
+
+  /**
+   * @brief Consumer side: the levels accumulated since the previous call
+   *
+   * @return std::nullopt if no block has been processed since
+   */
+  [[nodiscard]] std::optional<MeterSnapshot> pull() noexcept;
+
+private:
+  void resetAccumulators() noexcept;
+  void applyPeakBallistics(size_t numChannelsToMeter,
+                           size_t numSamples) noexcept;
+
+  TripleBuffer<MeterSnapshot> snapshots;
+  std::atomic<bool> consumed{false};
+  std::atomic<std::uint8_t> enabledMeters{DEFAULT_METERS};
+
+  // Audio thread only
+  int numChannels = 0;
+  double sampleRate = 44100.0;
+  std::uint8_t activeMeters = 0;
+  TruePeakDetector truePeakDetector;
+  LoudnessMeter loudnessMeter;
+  std::array<float, MeterSnapshot::MAX_CHANNELS> blockPeaks{};
+  std::array<float, MeterSnapshot::MAX_CHANNELS> peakEnvelopes{};
+  std::array<float, MeterSnapshot::MAX_CHANNELS> peakAccumulator{};
+  std::array<double, MeterSnapshot::MAX_CHANNELS> squareSumAccumulator{};
+  std::array<float, MeterSnapshot::MAX_CHANNELS> truePeakAccumulator{};
+  juce::int64 numAccumulatedSamples = 0;
+};
+}  // namespace webview_plugin
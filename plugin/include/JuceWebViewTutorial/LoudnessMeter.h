@@ -0,0 +1,80 @@
+#pragma once
+
+#include <array>
+#include <vector>
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <juce_dsp/juce_dsp.h>
+
+namespace webview_plugin {
+
+/**
+ * @brief Momentary (400 ms) and short-term (3 s) loudness after ITU-R
+ * BS.1770 / EBU R 128, in LUFS.
+ *
+ * Every channel is K-weighted (a high shelf followed by a high pass) and its
+ * squares are summed per 100 ms segment. Segments are weighted by channel
+ * (surround channels by 1.41, LFE channels not at all) and kept in a ring of
+ * the last 3 s, so both loudness values are updated every 100 ms from 4 and
+ * 30 segment sums respectively, without storing any audio.
+ */
+class LoudnessMeter {
+public:
+  static constexpr auto SEGMENT_SECONDS = 0.1;
+  static constexpr int MOMENTARY_SEGMENTS = 4;
+  static constexpr int SHORT_TERM_SEGMENTS = 30;
+  /** Reported for silence. */
+  static constexpr auto MIN_LOUDNESS = -100.f;
+
+  /** Designs the filters and allocates their state. Call off the audio
+   * thread. */
+  void prepare(double sampleRate, const juce::AudioChannelSet& channelLayout);
+
+  void reset() noexcept;
+
+  void process(const juce::dsp::AudioBlock<const float>& block) noexcept;
+
+  [[nodiscard]] float getMomentaryLoudness() const noexcept {
+    return momentaryLoudness;
+  }
+
+  [[nodiscard]] float getShortTermLoudness() const noexcept {
+    return shortTermLoudness;
+  }
+
+  /** Loudness weight of a channel type: 1, 1.41 for surround, 0 for LFE. */
+  [[nodiscard]] static float getChannelWeight(
+      juce::AudioChannelSet::ChannelType type) noexcept;
+
+private:
+  // Transposed direct form II, in double for the 38 Hz high pass
+  struct Biquad {
+    double b0 = 1.0, b1 = 0.0, b2 = 0.0, a1 = 0.0, a2 = 0.0;
+    double z1 = 0.0, z2 = 0.0;
+
+    double processSample(double x) noexcept {
+      const auto y = b0 * x + z1;
+      z1 = b1 * x - a1 * y + z2;
+      z2 = b2 * x - a2 * y;
+      return y;
+    }
+  };
+
+  struct Channel {
+    Biquad shelf;
+    Biquad highPass;
+    float weight = 1.f;
+  };
+
+  void finishSegment() noexcept;
+  [[nodiscard]] float getLoudness(int numSegments) const noexcept;
+
+  std::vector<Channel> channels;
+  std::vector<double> segmentSquareSums;
+  std::array<double, SHORT_TERM_SEGMENTS> segments{};
+  int nextSegment = 0;
+  int samplesPerSegment = 1;
+  int samplesInSegment = 0;
+  float momentaryLoudness = MIN_LOUDNESS;
+  float shortTermLoudness = MIN_LOUDNESS;
+};
+}  // namespace webview_plugin
@@ -0,0 +1,153 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <utility>
+#include <vector>
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <juce_dsp/juce_dsp.h>
+
+namespace webview_plugin {
+
+/**
+ * @brief Shaper, gain and equal-power pan fused into one pass per channel.
+ *
+ * Gain and pan glide to new values over RAMP_LENGTH_SECONDS. While they are
+ * static, the pan law is evaluated once per block and each sample is
+ * computed as (shape(x) * gain) * panGain, i.e., exactly what applying the
+ * shaper, the gain and the pan one after another would produce. While
+ * ramping, the per-sample gains are first written to small scratch buffers,
+ * so the audio itself is still traversed only once.
+ *
+ * Pan works on any channel layout: every channel is assigned to the left
+ * side, the right side or the centre in prepare() (see getPanSides()), and
+ * centre channels get a pan gain of exactly 1. All channels therefore run the
+ * same branch-free loop, whatever the layout.
+ */
+class OutputStage {
+public:
+  static constexpr auto RAMP_LENGTH_SECONDS = 0.02;
+
+  /** Which of the pan law's gains applies to a channel. */
+  enum class PanSide : std::uint8_t { centre, left, right };
+
+  /**
+   * Allocates the ramp buffers and assigns the channels of the layout to pan
+   * sides. Call off the audio thread.
+   */
+  void prepare(double sampleRate,
+               int maxBlockSize,
+               const juce::AudioChannelSet& channelLayout);
+
+  /** Jumps to the given values without ramping. */
+  void reset(float gain, float pan) noexcept;
+
+  /** Starts ramping towards the given values. */
+  void setTargets(float gain, float pan) noexcept {
+    gainSmoother.setTargetValue(gain);
+    panSmoother.setTargetValue(pan);
+  }
+
+  [[nodiscard]] bool isSmoothing() const noexcept {
+    return gainSmoother.isSmoothing() || panSmoother.isSmoothing();
+  }
+
+  /**
+   * @brief Equal-power pan law.
+   *
+   * @param pan 0 (left) to 1 (right)
+   * @return gains of the left and the right channel
+   */
+  [[nodiscard]] static std::pair<float, float> getPanGains(float pan) noexcept;
+
+  /**
+   * @brief Pan side of every channel of the layout.
+   *
+   * Mono is not panned and stereo pans left against right. Other named
+   * layouts, e.g., 5.1 or 7.1.4, pan every left-hand speaker against its
+   * right-hand counterpart, while centre, LFE and ambisonic channels stay
+   * untouched. Discrete layouts are treated as consecutive stereo pairs; an
+   * odd last channel stays untouched.
+   */
+  [[nodiscard]] static std::vector<PanSide> getPanSides(
+      const juce::AudioChannelSet& channelLayout);
+
+  /**
+   * @brief Processes the block in place.
+   *
+   * Channels beyond the layout passed to prepare() are not panned.
+   */
+  template <typename Shape>
+  void process(juce::dsp::AudioBlock<float> block, const Shape& shape) {
+    if (!isSmoothing()) {
+      processStatic(block, shape);
+      return;
+    }
+
+    // Ramps are computed in chunks that fit the scratch buffers
+    const auto maxChunkSize = gainRamp.size();
+    for (size_t start = 0; start < block.getNumSamples();
+         start += maxChunkSize) {
+      processRamping(block.getSubBlock(
+                         start, std::min(maxChunkSize,
+                                         block.getNumSamples() - start)),
+                     shape);
+    }
+  }
+
+private:
+  [[nodiscard]] PanSide getPanSide(size_t channel) const noexcept {
+    return channel < panSides.size() ? panSides[channel] : PanSide::centre;
+  }
+
+  template <typename Shape>
+  void processStatic(juce::dsp::AudioBlock<float> block, const Shape& shape) {
+    const auto gain = gainSmoother.getTargetValue();
+    const auto [leftGain, rightGain] = getPanGains(panSmoother.getTargetValue());
+    // Indexed by PanSide
+    const std::array sideGains{1.f, leftGain, rightGain};
+    const auto numSamples = block.getNumSamples();
+
+    for (auto channel = 0u; channel < block.getNumChannels(); ++channel) {
+      auto* samples = block.getChannelPointer(channel);
+      const auto panGain =
+          sideGains[static_cast<size_t>(getPanSide(channel))];
+      for (auto i = 0u; i < numSamples; ++i) {
+        samples[i] = shape(samples[i]) * gain * panGain;
+      }
+    }
+  }
+
+  template <typename Shape>
+  void processRamping(juce::dsp::AudioBlock<float> block, const Shape& shape) {
+    const auto numSamples = block.getNumSamples();
+    fillRamps(numSamples);
+
+    const auto* gains = gainRamp.data();
+    // Indexed by PanSide
+    const std::array sideRamps{unityRamp.data(), leftGainRamp.data(),
+                               rightGainRamp.data()};
+
+    for (auto channel = 0u; channel < block.getNumChannels(); ++channel) {
+      auto* samples = block.getChannelPointer(channel);
+      const auto* panGains =
+          sideRamps[static_cast<size_t>(getPanSide(channel))];
+      for (auto i = 0u; i < numSamples; ++i) {
+        samples[i] = shape(samples[i]) * gains[i] * panGains[i];
+      }
+    }
+  }
+
+  void fillRamps(size_t numSamples) noexcept;
+
+  juce::SmoothedValue<float> gainSmoother;
+  juce::SmoothedValue<float> panSmoother;
+  std::vector<PanSide> panSides;
+  std::vector<float> gainRamp;
+  std::vector<float> leftGainRamp;
+  std::vector<float> rightGainRamp;
+  // Pan gains of centre channels, all 1
+  std::vector<float> unityRamp;
+};
+}  // namespace webview_plugin
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <array>
+#include <memory>
+#include <juce_dsp/juce_dsp.h>
+
+namespace webview_plugin {
+
+/**
+ * @brief Runs a processing step at 1x, 2x, 4x or 8x the host sample rate.
+ *
+ * All oversamplers are allocated in prepare(), so switching the factor or the
+ * filter type on the audio thread only resets filter state. Every
+ * configuration uses integer latency so that it can be reported to the host
+ * exactly.
+ */
+class OversamplingStage {
+public:
+  /** In the order of the OVERSAMPLING_FILTER parameter choices. */
+  enum class FilterType { polyphaseIir, firEquiripple };
+
+  /** Choices of the OVERSAMPLING parameter: 1x, 2x, 4x, 8x. */
+  static constexpr int NUM_FACTORS = 4;
+
+  /** Allocates all oversamplers. Call off the audio thread. */
+  void prepare(int numChannels, int maxBlockSize);
+
+  void reset() noexcept;
+
+  /** Latency in base-rate samples of the given configuration. */
+  [[nodiscard]] int getLatencyInSamples(int factorIndex,
+                                        FilterType filterType) const noexcept;
+
+  /**
+   * @brief Upsamples the block, calls processOversampled with the oversampled
+   * block and downsamples the result back into the block.
+   *
+   * @param factorIndex 0 for 1x (processOversampled runs on block directly),
+   * 1 for 2x, 2 for 4x, 3 for 8x
+   */
+  template <typename Process>
+  void process(juce::dsp::AudioBlock<float> block,
+               int factorIndex,
+               FilterType filterType,
+               Process&& processOversampled) {
+    auto* oversampler = getOversampler(factorIndex, filterType);
+    if (oversampler == nullptr) {
+      processOversampled(block);
+      return;
+    }
+
+    if (oversampler != activeOversampler) {
+      // Don't let the previously active one's state leak into the output
+      oversampler->reset();
+      activeOversampler = oversampler;
+    }
+
+    processOversampled(oversampler->processSamplesUp(block));
+    oversampler->processSamplesDown(block);
+  }
+
+private:
+  using Oversampler = juce::dsp::Oversampling<float>;
+
+  [[nodiscard]] Oversampler* getOversampler(
+      int factorIndex,
+      FilterType filterType) const noexcept;
+
+  // Indexed by [filter type][factor index - 1]
+  std::array<std::array<std::unique_ptr<Oversampler>, NUM_FACTORS - 1>, 2>
+      oversamplers;
+  Oversampler* activeOversampler = nullptr;
+};
+}  // namespace webview_plugin
@@ -7,4 +7,13 @@ const juce::ParameterID GAIN{"GAIN", 1};
 const juce::ParameterID BYPASS{"BYPASS", 1};
 const juce::ParameterID DISTORTION_TYPE{"DISTORTION_TYPE", 1};
 const juce::ParameterID PAN{"PAN", 1};
+const juce::ParameterID OVERSAMPLING{"OVERSAMPLING", 1};
+const juce::ParameterID OVERSAMPLING_FILTER{"OVERSAMPLING_FILTER", 1};
+const juce::ParameterID HARMONIC_ENGINE{"HARMONIC_ENGINE", 1};
+const juce::ParameterID HARMONIC_EXCITER{"HARMONIC_EXCITER", 1};
+
+// Amplitude of a harmonic, HARMONIC_1 being the fundamental
+inline juce::ParameterID harmonic(int index) {
+  return juce::ParameterID{"HARMONIC_" + juce::String{index + 1}, 1};
+}
 }  // namespace webview_plugin::id
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include <juce_audio_processors/juce_audio_processors.h>
+#include "JuceWebViewTutorial/HarmonicTable.h"
+
+namespace webview_plugin {
+
+/**
+ * @brief Description of one processor parameter.
+ *
+ * The processor creates its parameters from getParameterSpecs() and the editor
+ * creates a web UI relay for every spec that asks for one, so a new parameter
+ * needs one more entry in the table and nothing else.
+ */
+struct ParameterSpec {
+  enum class Type { continuous, toggle, choice };
+
+  juce::ParameterID id;
+  juce::String name;
+  Type type = Type::continuous;
+  juce::NormalisableRange<float> range{0.f, 1.f};
+  /** For choices, the index of the default choice. */
+  float defaultValue = 0.f;
+  juce::StringArray choices;
+  /** Shown by hosts next to toggles. */
+  juce::String label;
+  /** Index into the harmonic table, -1 for other parameters. */
+  int harmonicIndex = -1;
+  /** Whether the web UI binds to the parameter through a relay. */
+  bool hasWebRelay = false;
+};
+
+/** All parameters in the order the processor creates them. */
+[[nodiscard]] const std::vector<ParameterSpec>& getParameterSpecs();
+
+/**
+ * @brief Amplitude of one harmonic, 0 to 100 like the harmonic table.
+ *
+ * Sets its bit in a mask shared by all harmonic parameters whenever its value
+ * changes, from whatever thread changes it, so that the audio thread
+ * recompiles the harmonic plans only after a change.
+ */
+class HarmonicParameter : public juce::AudioParameterFloat {
+public:
+  HarmonicParameter(const ParameterSpec& spec,
+                    std::atomic<std::uint64_t>& changedHarmonics);
+
+  [[nodiscard]] int getHarmonicIndex() const noexcept { return harmonicIndex; }
+
+private:
+  void valueChanged(float newValue) override;
+
+  const int harmonicIndex;
+  std::atomic<std::uint64_t>& changedHarmonics;
+};
+
+static_assert(HarmonicTable::MAX_HARMONICS <= 64,
+              "Every harmonic needs a bit in the change mask");
+
+/**
+ * Creates the parameter of a spec. Harmonic parameters report their changes
+ * to changedHarmonics.
+ */
+[[nodiscard]] std::unique_ptr<juce::RangedAudioParameter> createParameter(
+    const ParameterSpec& spec,
+    std::atomic<std::uint64_t>& changedHarmonics);
+}  // namespace webview_plugin
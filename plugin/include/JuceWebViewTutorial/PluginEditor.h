@@ -1,9 +1,12 @@
 #pragma once
 
 #include "PluginProcessor.h"
+#include "WebParameterRelays.h"
 #include "juce_gui_basics/juce_gui_basics.h"
 #include <juce_audio_processors/juce_audio_processors.h>
 #include <juce_gui_extra/juce_gui_extra.h>
+#include <memory>
+#include <optional>
 
 namespace webview_plugin {
 
@@ -13,18 +16,56 @@ public:
   explicit AudioPluginAudioProcessorEditor(AudioPluginAudioProcessor&);
   ~AudioPluginAudioProcessorEditor() override;
 
+  void paint(juce::Graphics&) override;
   void resized() override;
 
   void timerCallback() override;
 
 private:
+  class WebView;
   using Resource = juce::WebBrowserComponent::Resource;
+
+  // Milliseconds since construction began at which each phase of the editor's
+  // startup completed, served as startup.json
+  struct StartupTimeline {
+    std::optional<double> constructed;
+    std::optional<double> firstPaint;
+    std::optional<double> webViewCreated;
+    std::optional<double> pageLoaded;
+  };
+
+  void createWebView();
+  [[nodiscard]] double getStartupMilliseconds() const;
+  void emitMeterFrame();
+  void updateSpectrumAnalyzer();
+  void emitHarmonicChanges();
+  // {names, current} of the processor's programs, for the web UI
+  [[nodiscard]] juce::var describePrograms() const;
   std::optional<Resource> getResource(const juce::String& url) const;
   void nativeFunction(
       const juce::Array<juce::var>& args,
       juce::WebBrowserComponent::NativeFunctionCompletion completion);
 
   AudioPluginAudioProcessor& processorRef;
+  const double creationTime = juce::Time::getMillisecondCounterHiRes();
+  StartupTimeline startupTimeline;
+  // Web UI files and the WebView2 data folder, shared by all editors
+  juce::SharedResourcePointer<SharedResources> sharedResources;
+
+  // Aggregated from the processor's profiler ring in timerCallback()
+  ProfileStatistics profileStatistics;
+  // Last frame sent to the web UI, to skip sending identical ones
+  juce::MemoryBlock lastMeterFrame;
+  // Harmonic updates from the web UI, see "updateHarmonicsDelta"
+  juce::int64 lastHarmonicsSequenceNumber = -1;
+  std::array<float, 2 * HarmonicTable::MAX_HARMONICS> harmonicDeltas{};
+  // Harmonic values the web UI has, to send it only the ones that changed.
+  // NaN until sent.
+  std::array<float, HarmonicTable::MAX_HARMONICS> sentHarmonics;
+  // Applied whenever the analyzer (re)starts
+  SpectrumAnalyzer::Settings spectrumSettings;
+  // Last program announced to the web UI, -1 to announce the current one
+  int lastProgram = -1;
 
   // Native UI - Only one slider, one button, and one label
   juce::Slider gainSlider{"gain slider"};
@@ -33,12 +74,10 @@ private:
   juce::ButtonParameterAttachment bypassButtonAttachment;
   juce::Label infoLabel{"info label", "Simple UI"};
 
-  // Web UI - Only keep what we need
-  juce::WebSliderRelay webGainRelay;
-  juce::WebToggleButtonRelay webBypassRelay;
-  juce::WebBrowserComponent webView;
-  juce::WebSliderParameterAttachment webGainSliderAttachment;
-  juce::WebToggleButtonParameterAttachment webBypassToggleAttachment;
+  // Web UI
+  WebParameterRelays webParameterRelays;
+  // Created after the first paint, see paint()
+  std::unique_ptr<WebView> webView;
 
   JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(AudioPluginAudioProcessorEditor)
 };
@@ -1,11 +1,43 @@
 #pragma once
 
+#include <atomic>
 #include <juce_audio_processors/juce_audio_processors.h>
 #include <juce_dsp/juce_dsp.h>
+#include "JuceWebViewTutorial/AdditiveSynth.h"
+#include "JuceWebViewTutorial/AudioThreadProfiler.h"
+#include "JuceWebViewTutorial/BypassCrossfade.h"
+#include "JuceWebViewTutorial/ChebyshevPolynomial.h"
+#include "JuceWebViewTutorial/HarmonicMidiGenerator.h"
+#include "JuceWebViewTutorial/HarmonicTable.h"
+#include "JuceWebViewTutorial/HarmonicVoicing.h"
+#include "JuceWebViewTutorial/LevelMeter.h"
+#include "JuceWebViewTutorial/OutputStage.h"
+#include "JuceWebViewTutorial/OversamplingStage.h"
+#include "JuceWebViewTutorial/ParameterRegistry.h"
+#include "JuceWebViewTutorial/PresetBank.h"
+#include "JuceWebViewTutorial/ProgramSnapshot.h"
+#include "JuceWebViewTutorial/SharedResources.h"
+#include "JuceWebViewTutorial/SpectrumAnalyzer.h"
+#include "JuceWebViewTutorial/StateFormat.h"
+#include "JuceWebViewTutorial/SubBlockScheduler.h"
+#include "JuceWebViewTutorial/Waveshaper.h"
 
 namespace webview_plugin {
-class AudioPluginAudioProcessor : public juce::AudioProcessor {
+class AudioPluginAudioProcessor
+    : public juce::AudioProcessor,
+      private juce::AudioProcessorValueTreeState::Listener,
+      private juce::AsyncUpdater {
 public:
+  // Largest supported bus layout, e.g., 7.1.4 plus four more
+  static constexpr int MAX_CHANNELS = 16;
+  static_assert(MAX_CHANNELS <= MeterSnapshot::MAX_CHANNELS);
+
+  // Parameter changes take effect within this many samples
+  static constexpr int DEFAULT_MAX_SUB_BLOCK_SIZE = 32;
+
+  // Program changes fade out, switch and fade back in, each in this time
+  static constexpr auto PROGRAM_FADE_SECONDS = 0.005;
+
   AudioPluginAudioProcessor();
   ~AudioPluginAudioProcessor() override;
 
@@ -33,9 +65,31 @@ public:
   const juce::String getProgramName(int index) override;
   void changeProgramName(int index, const juce::String& newName) override;
 
+  // Replaces the programs with the presets of a bank file, each compiled into
+  // a snapshot, and switches to the first one. Message thread.
+  juce::Result loadPresetBank(const juce::File& file);
+  // Writes the programs plus the current state as a new program to a bank
+  // file, then loads it with the new program as the current one. The audio
+  // already matches it, so unlike a load this doesn't fade. Message thread.
+  juce::Result savePresetBank(const juce::File& file,
+                              const juce::String& newProgramName);
+  [[nodiscard]] bool hasPresetBank() const noexcept {
+    return programs != nullptr;
+  }
+
   void getStateInformation(juce::MemoryBlock& destData) override;
   void setStateInformation(const void* data, int sizeInBytes) override;
 
+  // Copies the parameters and harmonic settings. Safe on any thread but the
+  // audio thread.
+  [[nodiscard]] ProcessorState captureState() const;
+  // Compiles the state into a snapshot and switches the audio thread to it
+  // at once, like a program, then copies it into the parameters. Waits for the
+  // current block at most. setStateInformation() parses the whole state
+  // before calling this, so a corrupt state changes nothing. Not on the audio
+  // thread.
+  void restoreState(const ProcessorState& newState);
+
   [[nodiscard]] juce::AudioProcessorValueTreeState& getState() noexcept {
     return state;
   }
@@ -45,14 +99,43 @@ public:
     return *parameters.distortionType;
   }
 
-  // New methods for harmonic processing
-  void setHarmonicValues(const juce::Array<float>& newValues);
+  // The harmonics are parameters: these set and get their values in the 0-100
+  // range of the harmonic table. setHarmonicValues() zeroes the harmonics
+  // beyond newValues. Edits of the user pass isUserEdit, so that every
+  // changed harmonic is set within a change gesture, like a native control.
+  void setHarmonicValues(const juce::Array<float>& newValues,
+                         bool isUserEdit = false);
+  // Returns false if the index or value is invalid
+  bool setHarmonicValue(int index, float value, bool isUserEdit = false);
+  [[nodiscard]] float getHarmonicValue(int index) const noexcept;
   bool getHarmonicEnabled() const { return harmonicEnabled; }
   void setHarmonicEnabled(bool enabled) { harmonicEnabled = enabled; }
   int getRootNote() const { return rootNote; }
-  void setRootNote(int newRoot) { rootNote = newRoot; }
+  void setRootNote(int newRoot) { rootNote = juce::jlimit(0, 127, newRoot); }
+
+  // Longest stretch of samples processed with the same parameter values, see
+  // forEachSubBlock(). 0 splits blocks at MIDI events only. Any thread.
+  void setMaxSubBlockSize(int numSamples) noexcept {
+    maxSubBlockSize.store(juce::jmax(0, numSamples), std::memory_order_relaxed);
+  }
 
-  std::atomic<float> outputLevelLeft;
+  // Number of blocks whose harmonic MIDI exceeded the reserved event storage
+  [[nodiscard]] std::uint32_t getNumMidiCapacityOverflows() const noexcept {
+    return harmonicGenerator.getNumCapacityOverflows();
+  }
+
+  // Stage timings pushed by the audio thread, drained by the editor
+  [[nodiscard]] ProfilerRing& getProfilerRing() noexcept {
+    return profilerRing;
+  }
+
+  // Output levels published by the audio thread, pulled by the editor
+  [[nodiscard]] LevelMeter& getLevelMeter() noexcept { return levelMeter; }
+
+  // Started and stopped by the editor, fed with the output by the audio thread
+  [[nodiscard]] SpectrumAnalyzer& getSpectrumAnalyzer() noexcept {
+    return spectrumAnalyzer;
+  }
 
 private:
   struct Parameters {
@@ -60,28 +143,109 @@ private:
     juce::AudioParameterBool* bypass{nullptr};
     juce::AudioParameterChoice* distortionType{nullptr};
     juce::AudioParameterFloat* pan{nullptr};
+    juce::AudioParameterChoice* oversampling{nullptr};
+    juce::AudioParameterChoice* oversamplingFilter{nullptr};
+    juce::AudioParameterChoice* harmonicEngine{nullptr};
+    juce::AudioParameterBool* harmonicExciter{nullptr};
+    std::array<HarmonicParameter*, HarmonicTable::MAX_HARMONICS> harmonics{};
   };
 
-  [[nodiscard]] static juce::AudioProcessorValueTreeState::ParameterLayout
-  createParameterLayout(Parameters&);
+  // Choices of the HARMONIC_ENGINE parameter
+  enum class HarmonicEngine { midiOutput, additive };
 
+  [[nodiscard]] static juce::AudioProcessorValueTreeState::ParameterLayout
+  createParameterLayout(Parameters&,
+                        std::atomic<std::uint64_t>& changedHarmonics);
+  // Stores the parameter created for spec in the matching field
+  static void bindParameter(Parameters&,
+                            const ParameterSpec& spec,
+                            juce::RangedAudioParameter& parameter);
+
+  void parameterChanged(const juce::String& parameterID,
+                        float newValue) override;
+  void handleAsyncUpdate() override;
+  void updateLatency();
+  void processSubBlock(juce::dsp::AudioBlock<float> block,
+                       const AudioSettings& settings,
+                       bool renderSynth);
+  // The parameters, or the program switched to if they don't reflect it yet
+  [[nodiscard]] AudioSettings readAudioSettings() const noexcept;
+  [[nodiscard]] ProgramSnapshot compileProgram(
+      const preset_bank::Preset& preset) const;
+  // Message thread: parses and compiles every preset of a bank file
+  juce::Result readPresetBank(
+      const juce::File& file,
+      std::unique_ptr<const std::vector<ProgramSnapshot>>& newPrograms) const;
+  // Message thread: replaces the programs. With a negative currentProgram,
+  // switches to the first one; otherwise marks currentProgram as the one the
+  // parameters hold already.
+  void swapPrograms(
+      std::unique_ptr<const std::vector<ProgramSnapshot>> newPrograms,
+      int currentProgram);
+  // Audio thread: advances program fades and switches programs when silent
+  void updateProgram() noexcept;
+  void applyProgram(const ProgramSnapshot& program) noexcept;
+  void applyProgramFade(juce::dsp::AudioBlock<float> block) noexcept;
+  // Message thread: copies the program the audio thread switched to into the
+  // parameters and the harmonic settings
+  void syncProgram();
+  // Audio thread, or while it can't run: recompiles the plans and the exciter
+  // curve if any harmonic parameter changed since the last call
+  void updateHarmonics() noexcept;
+
+  // One bit per harmonic parameter, set when it changes, see
+  // HarmonicParameter. All set initially, so that the first call to
+  // updateHarmonics() compiles everything.
+  std::atomic<std::uint64_t> changedHarmonics{~std::uint64_t{}};
   Parameters parameters;
   juce::AudioProcessorValueTreeState state;
-  juce::dsp::BallisticsFilter<float> envelopeFollower;
-  juce::AudioBuffer<float> envelopeFollowerOutputBuffer;
+  juce::SharedResourcePointer<SharedResources> sharedResources;
+  Waveshaper waveshaper{sharedResources->getTanhTable()};
+  OversamplingStage oversampling;
+  OutputStage outputStage;
+  BypassCrossfade bypassCrossfade;
+  std::atomic<int> maxSubBlockSize = DEFAULT_MAX_SUB_BLOCK_SIZE;
+  LevelMeter levelMeter;
+  SpectrumAnalyzer spectrumAnalyzer;
 
   // Harmonic processing members
-  juce::Array<float> harmonicValues;
-  juce::CriticalSection harmonicLock; // Thread safety for harmonics
-  bool harmonicEnabled = true;
-  int rootNote = 60; // Middle C by default
-  
-  // MIDI note tracking for harmonics
-  struct ActiveNote {
-    int rootNote;
-    juce::Array<int> harmonicNotes;
-  };
-  juce::OwnedArray<ActiveNote> activeNotes;
+  std::atomic<bool> harmonicEnabled = true;
+  std::atomic<int> rootNote = 60; // Middle C by default
+  // Audio thread: the harmonic parameters' values and what's compiled from
+  // them, without locking or allocating. Compiling all of it takes a few
+  // microseconds and only happens in blocks in which a harmonic changed.
+  HarmonicTable harmonicValues{.size = HarmonicTable::MAX_HARMONICS};
+  VoicingPlan voicingPlan;
+  PartialPlan partialPlan;
+  // The harmonic exciter's curve, compiled along with the plans
+  ChebyshevPolynomial chebyshevPolynomial;
+  // Audio thread: the plan in use, voicingPlan or a program's
+  const VoicingPlan* activeVoicingPlan = &voicingPlan;
+  HarmonicMidiGenerator harmonicGenerator;
+  // Audio thread: whether the last block sent the harmonics as MIDI notes
+  bool sentHarmonicMidi = false;
+  // Audio thread: whether the wet stages were reset since the bypass became
+  // complete
+  bool wetStagesReset = false;
+  AdditiveSynth additiveSynth;
+  ProfilerRing profilerRing;
+
+  // Programs of the loaded bank, if any. Replaced on the message thread while
+  // holding the callback lock, read by the audio thread.
+  std::unique_ptr<const std::vector<ProgramSnapshot>> programs;
+  std::atomic<int> requestedProgram{0};
+  // The last restored state, compiled like a program. Replaced while holding
+  // the callback lock.
+  std::unique_ptr<const ProgramSnapshot> restoredState;
+  // Switched to by the audio thread but not yet copied into the parameters;
+  // until then, the audio thread reads its settings from here
+  std::atomic<const ProgramSnapshot*> unsyncedProgram{nullptr};
+  // Audio thread
+  enum class ProgramFade : std::uint8_t { none, out, in };
+  ProgramFade programFade = ProgramFade::none;
+  int activeProgram = -1;
+  juce::SmoothedValue<float> programGain{1.f};
+  std::vector<float> programGainRamp;
 
   JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(AudioPluginAudioProcessor)
 };
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include <juce_core/juce_core.h>
+#include "JuceWebViewTutorial/StateFormat.h"
+
+/**
+ * Binary format of a bank of presets.
+ *
+ * All integers are little-endian. The bank consists of
+ *   - an 8-byte header: magic "WVPB", 16-bit format version and 16-bit number
+ *     of presets,
+ *   - the index: per preset, the 32-bit offset and size of its record,
+ *   - the records: an 8-bit name length, the UTF-8 name and the preset's
+ *     state in the plugin's state format, see StateFormat.h.
+ *
+ * The index gives access to any preset without reading the others, so banks
+ * are read straight from a memory-mapped file.
+ */
+namespace webview_plugin::preset_bank {
+inline constexpr std::array<char, 4> MAGIC{'W', 'V', 'P', 'B'};
+inline constexpr std::uint16_t VERSION = 1;
+inline constexpr size_t HEADER_SIZE = 8;
+inline constexpr size_t INDEX_ENTRY_SIZE = 8;
+inline constexpr int MAX_PRESETS = 128;
+
+struct Preset {
+  juce::String name;
+  ProcessorState state;
+};
+
+/** Writes at most MAX_PRESETS presets; names are cut to 255 bytes. */
+void write(const std::vector<Preset>& presets, juce::OutputStream& output);
+
+/**
+ * @brief Read-only view of a bank file, mapped into memory.
+ *
+ * Only the header and the index are checked when opening; each preset is
+ * parsed when it's read.
+ */
+class Reader {
+public:
+  /** @return an error if the file can't be mapped or isn't a bank */
+  juce::Result open(const juce::File& file);
+
+  [[nodiscard]] int getNumPresets() const noexcept {
+    return static_cast<int>(records.size());
+  }
+
+  /** @return an error if the record is malformed */
+  juce::Result read(int index, Preset& preset) const;
+
+private:
+  struct Record {
+    const char* data = nullptr;
+    size_t size = 0;
+  };
+
+  std::unique_ptr<juce::MemoryMappedFile> mappedFile;
+  std::vector<Record> records;
+};
+}  // namespace webview_plugin::preset_bank
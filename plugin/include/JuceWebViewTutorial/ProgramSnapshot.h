@@ -0,0 +1,45 @@
+#pragma once
+
+#include <vector>
+#include <juce_core/juce_core.h>
+#include "JuceWebViewTutorial/AdditiveSynth.h"
+#include "JuceWebViewTutorial/ChebyshevPolynomial.h"
+#include "JuceWebViewTutorial/HarmonicVoicing.h"
+#include "JuceWebViewTutorial/StateFormat.h"
+
+namespace webview_plugin {
+
+/** Parameter values the audio thread reads once per sub-block. */
+struct AudioSettings {
+  float gain = 1.f;
+  float pan = 0.5f;
+  bool bypass = false;
+  int distortionType = 0;
+  int oversampling = 0;
+  int oversamplingFilter = 0;
+  int harmonicEngine = 0;
+  // Replaces the curve of distortionType
+  bool harmonicExciter = false;
+};
+
+/**
+ * @brief A preset compiled into everything the processor needs to switch to
+ * it: the parameter values, in the form the audio thread reads them and
+ * normalized for the host, and the harmonic plans.
+ *
+ * Built on the message thread when a bank is loaded, or when a state is
+ * restored, and never changed afterwards, so the audio thread switches
+ * programs by pointing at one.
+ */
+struct ProgramSnapshot {
+  juce::String name;
+  /** As stored in the bank, to write it out again. */
+  ProcessorState state;
+  /** One per processor parameter, in the order of getParameters(). */
+  std::vector<float> normalizedValues;
+  AudioSettings settings;
+  VoicingPlan voicingPlan;
+  PartialPlan partialPlan;
+  ChebyshevPolynomial polynomial;
+};
+}  // namespace webview_plugin
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <memory>
+#include <mutex>
+#include <juce_core/juce_core.h>
+#include "JuceWebViewTutorial/AssetStore.h"
+#include "JuceWebViewTutorial/Waveshaper.h"
+
+// Set by tools that use the processor without its editor, e.g., the benchmark
+#ifndef WEBVIEW_PLUGIN_HEADLESS
+#define WEBVIEW_PLUGIN_HEADLESS 0
+#endif
+
+namespace webview_plugin {
+
+/**
+ * @brief Immutable data shared by all processors and editors of the process.
+ *
+ * Hold it through a juce::SharedResourcePointer<SharedResources>: the pool is
+ * created by the first instance and destroyed with the last one, so a session
+ * with a hundred plugin instances builds its tables once, and unloading the
+ * plugin frees the inflated web UI files.
+ */
+class SharedResources {
+public:
+  SharedResources();
+  ~SharedResources();
+
+  [[nodiscard]] const LookupTableTanh& getTanhTable() const noexcept {
+    return tanhTable;
+  }
+
+#if !WEBVIEW_PLUGIN_HEADLESS
+  /** The web UI files, whose manifest is read on the first call. */
+  [[nodiscard]] const AssetStore& getAssetStore() const;
+
+  /** User data folder of every WebView2 of the process. */
+  [[nodiscard]] const juce::File& getWebViewDataFolder() const noexcept {
+    return webViewDataFolder;
+  }
+#endif
+
+private:
+  LookupTableTanh tanhTable;
+  juce::File webViewDataFolder;
+  mutable std::once_flag assetStoreCreated;
+  mutable std::unique_ptr<const AssetStore> assetStore;
+
+  JUCE_DECLARE_NON_COPYABLE(SharedResources)
+};
+}  // namespace webview_plugin
@@ -0,0 +1,118 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <utility>
+#include <vector>
+#include <juce_dsp/juce_dsp.h>
+#include "JuceWebViewTutorial/AudioThreadProfiler.h"
+#include "JuceWebViewTutorial/TripleBuffer.h"
+
+namespace webview_plugin {
+
+/**
+ * @brief Magnitude spectrum of the output, computed on a worker thread.
+ *
+ * The audio thread only copies the mono sum of each block into a lock-free
+ * FIFO, and only while the analyzer runs. The worker thread reads the FIFO,
+ * runs a Hann-windowed FFT every hop, groups the bins into logarithmically
+ * spaced bands, smooths them over time and publishes the latest frame through
+ * a triple buffer. The consumer picks up frames at its own (display) rate,
+ * which decimates them.
+ */
+class SpectrumAnalyzer : private juce::Thread {
+public:
+  static constexpr int NUM_BANDS = 128;
+  static constexpr auto MIN_FREQUENCY = 20.0;
+  static constexpr auto MAX_FREQUENCY = 20000.0;
+  static constexpr auto MIN_DECIBELS = -100.f;
+
+  struct Settings {
+    /** FFT size is 2^fftOrder. */
+    int fftOrder = 11;
+    /** Number of FFTs per FFT size, e.g., 4 for 75% overlap. */
+    int overlap = 4;
+    /** 0 follows the spectrum immediately, values close to 1 fall slowly. */
+    float releaseSmoothing = 0.7f;
+  };
+
+  static constexpr int MIN_FFT_ORDER = 8;
+  static constexpr int MAX_FFT_ORDER = 15;
+
+  struct Frame {
+    /** Level of each band, from MIN_FREQUENCY up, in dB. */
+    std::array<float, NUM_BANDS> decibels{};
+  };
+
+  SpectrumAnalyzer();
+  ~SpectrumAnalyzer() override;
+
+  /** Any thread. */
+  void setSampleRate(double newSampleRate) noexcept {
+    sampleRate.store(newSampleRate, std::memory_order_relaxed);
+  }
+
+  /** Audio thread: queues the mono sum of the block if the analyzer runs. */
+  void pushSamples(const juce::dsp::AudioBlock<const float>& block) noexcept;
+
+  /** Message thread: allocates everything and starts the worker thread. */
+  void start(const Settings& newSettings);
+
+  /** Message thread: stops the worker thread. */
+  void stop();
+
+  [[nodiscard]] bool isRunning() const noexcept {
+    return running.load(std::memory_order_relaxed);
+  }
+
+  [[nodiscard]] const Settings& getSettings() const noexcept {
+    return settings;
+  }
+
+  /** Consumer side: the latest frame if there is a new one. */
+  [[nodiscard]] std::optional<Frame> pullFrame() noexcept;
+
+  /** Timings of the worker thread, see ProfilerStage::spectrum. */
+  [[nodiscard]] ProfilerRing& getProfilerRing() noexcept {
+    return profilerRing;
+  }
+
+  /** Samples dropped because the worker thread didn't keep up. */
+  [[nodiscard]] std::uint32_t getNumDroppedSamples() const noexcept {
+    return numDroppedSamples.load(std::memory_order_relaxed);
+  }
+
+private:
+  static constexpr int FIFO_CAPACITY = 1 << 15;
+  static constexpr int POLL_INTERVAL_MS = 10;
+
+  void run() override;
+  void analyze();
+  void updateBands(double newSampleRate);
+
+  juce::AbstractFifo fifo{FIFO_CAPACITY};
+  std::vector<float> fifoBuffer;
+  std::atomic<bool> running{false};
+  std::atomic<double> sampleRate{44100.0};
+  std::atomic<std::uint32_t> numDroppedSamples{0};
+  TripleBuffer<Frame> frames;
+  ProfilerRing profilerRing;
+
+  // Worker thread only, set up in start()
+  Settings settings;
+  std::unique_ptr<juce::dsp::FFT> fft;
+  std::unique_ptr<juce::dsp::WindowingFunction<float>> window;
+  std::vector<float> history;
+  std::vector<float> fftData;
+  size_t historyPosition = 0;
+  int hopSize = 0;
+  int samplesUntilNextFrame = 0;
+  double bandSampleRate = 0.0;
+  // First and last FFT bin of each band
+  std::array<std::pair<int, int>, NUM_BANDS> bandBins{};
+  std::array<float, NUM_BANDS> smoothedDecibels{};
+};
+}  // namespace webview_plugin
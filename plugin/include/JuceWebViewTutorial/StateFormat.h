@@ -0,0 +1,57 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <utility>
+#include <vector>
+#include <juce_core/juce_core.h>
+#include "JuceWebViewTutorial/HarmonicTable.h"
+
+namespace webview_plugin {
+
+/** Everything getStateInformation() stores, detached from the processor. */
+struct ProcessorState {
+  /** Parameter IDs and their (not normalized) values. */
+  std::vector<std::pair<juce::String, float>> parameters;
+  HarmonicTable harmonics;
+  int rootNote = 60;
+  bool harmonicEnabled = true;
+};
+
+/**
+ * Binary format of the processor's state.
+ *
+ * All integers are little-endian. The state starts with the magic "WVPS" and
+ * the 16-bit version of the writer, followed by fields of the form
+ *   [16-bit tag][32-bit payload length][payload].
+ * Readers skip fields with tags they don't know, so newer and older versions
+ * can read each other's states: fields are only ever added. If the encoding
+ * of a field has to change, it gets a new tag.
+ */
+namespace state_format {
+inline constexpr std::array<char, 4> MAGIC{'W', 'V', 'P', 'S'};
+inline constexpr std::uint16_t VERSION = 1;
+
+enum class Tag : std::uint16_t {
+  /** 32-bit count, then per parameter: 8-bit ID length, UTF-8 ID, float. */
+  parameters = 1,
+  /** 32-bit count, then that many floats. */
+  harmonics = 2,
+  /** 32-bit MIDI note number. */
+  rootNote = 3,
+  /** 8-bit boolean. */
+  harmonicEnabled = 4
+};
+
+void write(const ProcessorState& state, juce::OutputStream& output);
+
+/**
+ * @brief Parses a state written by write()
+ *
+ * Fields missing from the data keep the values state had on input.
+ * @return an error if the data isn't a state or is truncated, in which case
+ * state may be partially updated
+ */
+juce::Result read(const void* data, size_t sizeInBytes, ProcessorState& state);
+}  // namespace state_format
+}  // namespace webview_plugin
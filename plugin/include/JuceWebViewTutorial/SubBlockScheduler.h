@@ -0,0 +1,41 @@
+#pragma once
+
+#include <algorithm>
+#include <juce_audio_basics/juce_audio_basics.h>
+
+namespace webview_plugin {
+
+/**
+ * @brief Splits a block into sub-blocks that start at every MIDI event and
+ * are at most maxSubBlockSize samples long.
+ *
+ * Whatever is read once per sub-block, e.g., parameter values, then takes
+ * effect at most maxSubBlockSize samples late, and MIDI-driven processing can
+ * treat every sub-block as free of events. Doesn't allocate.
+ *
+ * @param maxSubBlockSize 0 to split at MIDI events only
+ * @param processSubBlock called with the start and the length of each
+ * sub-block, in order; the sub-blocks cover all numSamples samples
+ */
+template <typename ProcessSubBlock>
+void forEachSubBlock(int numSamples,
+                     const juce::MidiBuffer& midi,
+                     int maxSubBlockSize,
+                     ProcessSubBlock&& processSubBlock) {
+  const auto limit = maxSubBlockSize > 0 ? maxSubBlockSize : numSamples;
+  auto start = 0;
+
+  const auto processUntil = [&](int end) {
+    while (start < end) {
+      const auto length = std::min(limit, end - start);
+      processSubBlock(start, length);
+      start += length;
+    }
+  };
+
+  for (const auto metadata : midi) {
+    processUntil(std::clamp(metadata.samplePosition, start, numSamples));
+  }
+  processUntil(numSamples);
+}
+}  // namespace webview_plugin
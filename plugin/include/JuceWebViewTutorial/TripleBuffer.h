@@ -0,0 +1,72 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+
+namespace webview_plugin {
+
+/**
+ * @brief Wait-free single-producer/single-consumer snapshot exchange.
+ *
+ * The writer always owns one of the three slots, the reader owns another and
+ * the third one sits in the middle. Publishing swaps the writer's slot with
+ * the middle one and marks it fresh; reading swaps the middle slot with the
+ * reader's only when something new was published. Neither side ever waits
+ * for the other, locks or allocates, which makes it suitable for handing
+ * data from the message thread to the audio thread and vice versa.
+ *
+ * @tparam T trivially copyable, fixed-size payload
+ */
+template <typename T>
+class TripleBuffer {
+public:
+  TripleBuffer() = default;
+
+  explicit TripleBuffer(const T& initialValue) {
+    buffers.fill(initialValue);
+  }
+
+  /** Writer side: copies the value into the back slot and publishes it. */
+  void write(const T& value) noexcept {
+    buffers[static_cast<size_t>(writeIndex)] = value;
+    publish();
+  }
+
+  /** Writer side: the back slot, to be filled in place before publish(). */
+  [[nodiscard]] T& getWriteBuffer() noexcept {
+    return buffers[static_cast<size_t>(writeIndex)];
+  }
+
+  /** Writer side: makes the back slot visible to the reader. */
+  void publish() noexcept {
+    writeIndex = middle.exchange(writeIndex | FRESH_BIT,
+                                 std::memory_order_acq_rel) &
+                 INDEX_MASK;
+  }
+
+  /** Reader side: returns the most recently published value. */
+  [[nodiscard]] const T& read() noexcept {
+    if (middle.load(std::memory_order_relaxed) & FRESH_BIT) {
+      readIndex =
+          middle.exchange(readIndex, std::memory_order_acq_rel) & INDEX_MASK;
+    }
+    return buffers[static_cast<size_t>(readIndex)];
+  }
+
+  /** Reader side: true if read() would return a newer value. */
+  [[nodiscard]] bool hasNewData() const noexcept {
+    return (middle.load(std::memory_order_acquire) & FRESH_BIT) != 0;
+  }
+
+private:
+  static constexpr int FRESH_BIT = 4;
+  static constexpr int INDEX_MASK = 3;
+
+  std::array<T, 3> buffers{};
+  std::atomic<int> middle{1};
+  int writeIndex = 0;
+  int readIndex = 2;
+
+  static_assert(std::atomic<int>::is_always_lock_free);
+};
+}  // namespace webview_plugin
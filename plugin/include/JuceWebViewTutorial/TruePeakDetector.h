@@ -0,0 +1,51 @@
+#pragma once
+
+#include <array>
+#include <vector>
+#include <juce_core/juce_core.h>
+
+namespace webview_plugin {
+
+/**
+ * @brief Peak level of the signal reconstructed at 4x the sample rate, after
+ * ITU-R BS.1770.
+ *
+ * Inter-sample peaks that a sample peak meter misses show up here. The
+ * signal is interpolated with a 48-tap windowed-sinc filter split into four
+ * phases of TAPS_PER_PHASE taps, so each input sample costs four short dot
+ * products that compilers vectorize. The filter is centred on an input
+ * sample: the first phase reproduces the samples, so the true peak is never
+ * below the sample peak. Only the maximum of the interpolated samples is
+ * kept; they are never written out.
+ *
+ * The samples come out TAPS_PER_PHASE / 2 samples late, so the peak of the
+ * last few samples of a block is reported with the next one.
+ */
+class TruePeakDetector {
+public:
+  static constexpr int OVERSAMPLING_FACTOR = 4;
+  static constexpr int TAPS_PER_PHASE = 12;
+
+  TruePeakDetector();
+
+  /** Allocates the filter history. Call off the audio thread. */
+  void prepare(int numChannels, int maxBlockSize);
+
+  void reset() noexcept;
+
+  /** @return the highest absolute interpolated sample of the channel */
+  [[nodiscard]] float process(int channel,
+                              const float* samples,
+                              size_t numSamples) noexcept;
+
+private:
+  // Coefficients of each phase, in reverse order, so that a dot product with
+  // the input at increasing addresses is the convolution
+  std::array<std::array<float, TAPS_PER_PHASE>, OVERSAMPLING_FACTOR> phases{};
+  // The last TAPS_PER_PHASE - 1 samples of every channel followed by the
+  // current chunk of the channel being processed
+  std::vector<float> history;
+  std::vector<float> scratch;
+  int numChannels = 0;
+};
+}  // namespace webview_plugin
@@ -0,0 +1,192 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+#include <juce_dsp/juce_dsp.h>
+#include "JuceWebViewTutorial/ChebyshevPolynomial.h"
+
+namespace webview_plugin {
+
+/**
+ * Shaper curves: the DISTORTION_TYPE parameter choices in order, then the
+ * Chebyshev exciter, which the HARMONIC_EXCITER parameter switches to.
+ */
+enum class ShaperType { none, tanh, sigmoid, chebyshev };
+
+/**
+ * @brief tanh(x) as a [7/6] Padé approximant.
+ *
+ * The input is clamped to +/-INPUT_LIMIT, where the approximant meets the
+ * saturated tanh. Maximum absolute error is 1.1e-4 on the whole real line.
+ *
+ * The clamp is written arithmetically rather than with comparisons: a
+ * conditional followed by a division keeps compilers from vectorizing loops
+ * over this function unless trapping math is disabled.
+ */
+struct RationalTanh {
+  static constexpr auto INPUT_LIMIT = 4.8f;
+  static constexpr auto MAX_ERROR = 1.1e-4f;
+
+  float operator()(float x) const noexcept {
+    // clamp(x, -L, L) == (|x + L| - |x - L|) / 2
+    x = 0.5f * (std::abs(x + INPUT_LIMIT) - std::abs(x - INPUT_LIMIT));
+    const auto x2 = x * x;
+    const auto numerator =
+        x * (135135.f + x2 * (17325.f + x2 * (378.f + x2)));
+    const auto denominator =
+        135135.f + x2 * (62370.f + x2 * (3150.f + x2 * 28.f));
+    return numerator / denominator;
+  }
+};
+
+/**
+ * @brief tanh(x) read from a linearly interpolated table.
+ *
+ * The table covers [-INPUT_LIMIT, INPUT_LIMIT] with TABLE_SIZE segments.
+ * Linear interpolation error is bounded by h^2 / 8 * max|tanh''| with
+ * h = 2 * INPUT_LIMIT / TABLE_SIZE, i.e., 1.5e-6, and the clamped tails add
+ * at most 1 - tanh(INPUT_LIMIT) = 2.3e-7. NaN reads as -INPUT_LIMIT.
+ *
+ * The table takes 16 kB and never changes: share one instance, see
+ * SharedResources.
+ */
+class LookupTableTanh {
+public:
+  static constexpr auto INPUT_LIMIT = 8.f;
+  static constexpr auto TABLE_SIZE = 4096;
+  static constexpr auto MAX_ERROR = 2e-6f;
+
+  LookupTableTanh();
+
+  float operator()(float x) const noexcept {
+    constexpr auto SCALE = TABLE_SIZE / (2.f * INPUT_LIMIT);
+    // Unlike std::min and std::max, these comparisons also clamp NaN, which
+    // would make the index below undefined
+    x = x > -INPUT_LIMIT ? x : -INPUT_LIMIT;
+    x = x < INPUT_LIMIT ? x : INPUT_LIMIT;
+    const auto position = (x + INPUT_LIMIT) * SCALE;
+    const auto index = std::min(static_cast<int>(position), TABLE_SIZE - 1);
+    const auto fraction = position - static_cast<float>(index);
+    const auto* entry = table.data() + index;
+    return entry[0] + fraction * (entry[1] - entry[0]);
+  }
+
+private:
+  std::vector<float> table;
+};
+
+/** Passes samples through unchanged, i.e., distortion type "none". */
+struct IdentityShape {
+  float operator()(float x) const noexcept { return x; }
+};
+
+/**
+ * @brief outputScale * tanh(inputScale * x) for a given tanh kernel.
+ *
+ * Both distortion curves are of this form:
+ *  - tanh(kx)/tanh(k) directly,
+ *  - the sigmoid 2 / (1 + exp(-kx)) - 1, which equals tanh(kx / 2).
+ */
+template <typename TanhKernel>
+struct ScaledTanh {
+  const TanhKernel& tanh;
+  float inputScale;
+  float outputScale;
+
+  float operator()(float x) const noexcept {
+    return outputScale * tanh(inputScale * x);
+  }
+};
+
+/**
+ * @brief Applies the distortion curves to audio blocks.
+ *
+ * The curve is picked once per block and each channel is processed by a
+ * loop instantiated for that curve, with no per-sample branching. Other
+ * per-sample loops can fuse the curve into their own body through visit().
+ *
+ * The Chebyshev exciter evaluates a polynomial of up to 64th degree per
+ * sample: process() runs it vectorized across samples, which is much faster
+ * than fusing it through visit().
+ */
+class Waveshaper {
+public:
+  enum class Mode {
+    /** Rational approximation, see RationalTanh. */
+    rational,
+    /** Interpolated lookup table, see LookupTableTanh. */
+    lookupTable
+  };
+
+  static constexpr auto SATURATION = 5.f;
+
+  /** @param tanhTable must outlive the shaper */
+  explicit Waveshaper(const LookupTableTanh& tanhTable) noexcept
+      : lookupTableTanh{tanhTable} {}
+
+  void setMode(Mode newMode) noexcept { mode = newMode; }
+  [[nodiscard]] Mode getMode() const noexcept { return mode; }
+
+  /** Audio thread: the exciter curve, which must stay valid while in use. */
+  void setPolynomial(const ChebyshevPolynomial& newPolynomial) noexcept {
+    polynomial = &newPolynomial;
+  }
+
+  void process(juce::dsp::AudioBlock<float> block,
+               ShaperType type) const noexcept;
+
+  /** Calls visitor with the shape functor of the given curve. */
+  template <typename Visitor>
+  void visit(ShaperType type, Visitor&& visitor) const {
+    if (mode == Mode::lookupTable) {
+      visit(type, lookupTableTanh, visitor);
+    } else {
+      visit(type, rationalTanh, visitor);
+    }
+  }
+
+  /** Runs shape over every sample of the block. */
+  template <typename Shape>
+  static void processWith(juce::dsp::AudioBlock<float> block,
+                          const Shape& shape) noexcept {
+    const auto numSamples = block.getNumSamples();
+    for (auto channel = 0u; channel < block.getNumChannels(); ++channel) {
+      auto* samples = block.getChannelPointer(channel);
+      for (auto i = 0u; i < numSamples; ++i) {
+        samples[i] = shape(samples[i]);
+      }
+    }
+  }
+
+private:
+  template <typename TanhKernel, typename Visitor>
+  void visit(ShaperType type,
+             const TanhKernel& tanh,
+             Visitor& visitor) const {
+    switch (type) {
+      case ShaperType::tanh:
+        // tanh(kx)/tanh(k)
+        visitor(ScaledTanh<TanhKernel>{tanh, SATURATION, tanhNormalization});
+        break;
+      case ShaperType::sigmoid:
+        // 2 / (1 + exp(-kx)) - 1 == tanh(kx / 2)
+        visitor(ScaledTanh<TanhKernel>{tanh, 0.5f * SATURATION, 1.f});
+        break;
+      case ShaperType::chebyshev:
+        visitor(*polynomial);
+        break;
+      case ShaperType::none:
+        visitor(IdentityShape{});
+        break;
+    }
+  }
+
+  RationalTanh rationalTanh;
+  const LookupTableTanh& lookupTableTanh;
+  float tanhNormalization = 1.f / std::tanh(SATURATION);
+  static inline const ChebyshevPolynomial silentPolynomial{};
+  const ChebyshevPolynomial* polynomial = &silentPolynomial;
+  Mode mode = Mode::rational;
+};
+}  // namespace webview_plugin
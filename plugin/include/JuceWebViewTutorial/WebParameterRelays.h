@@ -0,0 +1,39 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+#include <juce_audio_processors/juce_audio_processors.h>
+#include <juce_gui_extra/juce_gui_extra.h>
+
+namespace webview_plugin {
+
+/**
+ * @brief Web UI relays, and their attachments, of all parameters whose spec
+ * asks for one, see ParameterSpec::hasWebRelay.
+ *
+ * Continuous parameters get a slider relay, toggles a toggle button relay and
+ * choices a combo box relay, each named after the parameter's ID. Must
+ * outlive the browser the relays are added to.
+ */
+class WebParameterRelays {
+public:
+  explicit WebParameterRelays(juce::AudioProcessorValueTreeState& state);
+
+  /** Adds the relays' native integration to a browser's options. */
+  [[nodiscard]] juce::WebBrowserComponent::Options addTo(
+      juce::WebBrowserComponent::Options options);
+
+private:
+  std::vector<std::unique_ptr<juce::WebSliderRelay>> sliderRelays;
+  std::vector<std::unique_ptr<juce::WebToggleButtonRelay>> toggleRelays;
+  std::vector<std::unique_ptr<juce::WebComboBoxRelay>> comboBoxRelays;
+  std::vector<std::unique_ptr<juce::WebSliderParameterAttachment>>
+      sliderAttachments;
+  std::vector<std::unique_ptr<juce::WebToggleButtonParameterAttachment>>
+      toggleAttachments;
+  std::vector<std::unique_ptr<juce::WebComboBoxParameterAttachment>>
+      comboBoxAttachments;
+
+  JUCE_DECLARE_NON_COPYABLE(WebParameterRelays)
+};
+}  // namespace webview_plugin
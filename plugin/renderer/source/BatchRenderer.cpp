@@ -0,0 +1,563 @@
+#include "JuceWebViewTutorial/PluginProcessor.h"
+#include <juce_audio_formats/juce_audio_formats.h>
+#include <juce_audio_processors/juce_audio_processors.h>
+#include <juce_events/juce_events.h>
+#include <juce_gui_basics/juce_gui_basics.h>
+#include "JuceWebViewTutorial/StateFormat.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * Renders audio files through AudioPluginAudioProcessor without a host.
+ *
+ * Every input file is streamed through the processor in large blocks and
+ * written to the output directory under the same name and in the same format
+ * and bit depth. Files are spread over a pool of worker threads, each with its
+ * own processor instance, so the throughput scales with the number of cores.
+ * Disk I/O runs on a background thread per worker: the input is read ahead
+ * and the output is written behind the processing.
+ *
+ * The preset is either a state saved by the plugin or a JSON object like
+ *   {"parameters": {"GAIN": 0.8, "DISTORTION_TYPE": 1},
+ *    "harmonics": [100, 50, 25], "rootNote": 48, "harmonicEnabled": true}
+ * where parameter values are not normalized. The MIDI file, if given, is
+ * played from the start of every input file.
+ *
+ * The output is compensated for the processor's latency. Reports the
+ * throughput of every file and of the whole batch as JSON.
+ *
+ * Usage:
+ *   JuceWebViewPluginRenderer --output-dir=rendered [--preset=preset.json]
+ *       [--midi=notes.mid] [--threads=8] [--block-size=4096]
+ *       [--report=report.json] input.wav stems/ ...
+ */
+namespace webview_plugin::renderer {
+namespace {
+struct Options {
+  juce::Array<juce::File> inputFiles;
+  juce::File outputDirectory;
+  juce::File presetFile;
+  juce::File midiFile;
+  int numThreads = juce::SystemStats::getNumPhysicalCpus();
+  int blockSize = 4096;
+  juce::File reportFile;
+};
+
+struct FileResult {
+  juce::File input;
+  juce::File output;
+  juce::String error;
+  int numChannels = 0;
+  double sampleRate = 0.0;
+  juce::int64 numSamples = 0;
+  double wallSeconds = 0.0;
+  double processSeconds = 0.0;
+  int worker = 0;
+};
+
+// Blocks read ahead of and written behind the processing
+constexpr auto NUM_BUFFERED_BLOCKS = 8;
+
+juce::File getFile(const juce::String& path) {
+  return juce::File::getCurrentWorkingDirectory().getChildFile(
+      path.unquoted());
+}
+
+// Adds the file, or the supported files in the directory and its
+// subdirectories
+void addInputs(const juce::File& file,
+               const juce::String& wildcard,
+               juce::Array<juce::File>& inputFiles) {
+  if (!file.isDirectory()) {
+    inputFiles.add(file);
+    return;
+  }
+
+  auto files = file.findChildFiles(juce::File::findFiles, true, wildcard);
+  files.sort();
+  inputFiles.addArray(files);
+}
+
+Options parseOptions(const juce::ArgumentList& arguments,
+                     const juce::String& wildcard) {
+  Options options;
+
+  if (const auto value = arguments.getValueForOption("--output-dir");
+      value.isNotEmpty())
+    options.outputDirectory = getFile(value);
+  if (const auto value = arguments.getValueForOption("--preset");
+      value.isNotEmpty())
+    options.presetFile = getFile(value);
+  if (const auto value = arguments.getValueForOption("--midi");
+      value.isNotEmpty())
+    options.midiFile = getFile(value);
+  if (const auto value = arguments.getValueForOption("--threads");
+      value.isNotEmpty())
+    options.numThreads = value.getIntValue();
+  if (const auto value = arguments.getValueForOption("--block-size");
+      value.isNotEmpty())
+    options.blockSize = value.getIntValue();
+  if (const auto value = arguments.getValueForOption("--report");
+      value.isNotEmpty())
+    options.reportFile = getFile(value);
+
+  options.numThreads = juce::jmax(1, options.numThreads);
+  options.blockSize = juce::jmax(1, options.blockSize);
+
+  for (const auto& argument : arguments.arguments) {
+    if (!argument.isOption())
+      addInputs(getFile(argument.text), wildcard, options.inputFiles);
+  }
+
+  return options;
+}
+
+juce::AudioChannelSet getChannelLayout(int numChannels) {
+  switch (numChannels) {
+    case 1:
+      return juce::AudioChannelSet::mono();
+    case 2:
+      return juce::AudioChannelSet::stereo();
+    case 6:
+      return juce::AudioChannelSet::create5point1();
+    case 8:
+      return juce::AudioChannelSet::create7point1();
+    case 10:
+      return juce::AudioChannelSet::create7point1point2();
+    case 12:
+      return juce::AudioChannelSet::create7point1point4();
+    default:
+      return juce::AudioChannelSet::discreteChannels(numChannels);
+  }
+}
+
+// Applies a JSON preset on top of the default state
+juce::Result readJsonPreset(const juce::String& text, ProcessorState& preset) {
+  juce::var json;
+  if (const auto result = juce::JSON::parse(text, json); result.failed())
+    return result;
+  if (!json.isObject())
+    return juce::Result::fail("The preset is neither a state nor an object");
+
+  if (const auto* parameters =
+          json.getProperty("parameters", {}).getDynamicObject()) {
+    for (const auto& [name, value] : parameters->getProperties()) {
+      const auto id = name.toString();
+      const auto existing =
+          std::find_if(preset.parameters.begin(), preset.parameters.end(),
+                       [&id](const auto& entry) { return entry.first == id; });
+      if (existing == preset.parameters.end())
+        return juce::Result::fail("Unknown parameter " + id);
+      existing->second = static_cast<float>(value);
+    }
+  }
+
+  if (const auto* harmonics = json.getProperty("harmonics", {}).getArray()) {
+    preset.harmonics.size =
+        juce::jmin(harmonics->size(), HarmonicTable::MAX_HARMONICS);
+    for (auto i = 0; i < preset.harmonics.size; ++i) {
+      preset.harmonics.values[static_cast<size_t>(i)] =
+          static_cast<float>(harmonics->getReference(i));
+    }
+  }
+
+  if (json.hasProperty("rootNote"))
+    preset.rootNote =
+        juce::jlimit(0, 127, static_cast<int>(json.getProperty("rootNote", 60)));
+  if (json.hasProperty("harmonicEnabled"))
+    preset.harmonicEnabled =
+        static_cast<bool>(json.getProperty("harmonicEnabled", true));
+
+  return juce::Result::ok();
+}
+
+juce::Result readPreset(const juce::File& file, ProcessorState& preset) {
+  // The defaults of every parameter, overridden by the preset
+  preset = AudioPluginAudioProcessor{}.captureState();
+  if (file == juce::File{})
+    return juce::Result::ok();
+
+  juce::MemoryBlock data;
+  if (!file.loadFileAsData(data))
+    return juce::Result::fail("Could not read " + file.getFullPathName());
+
+  if (data.getSize() >= state_format::MAGIC.size() &&
+      std::equal(state_format::MAGIC.begin(), state_format::MAGIC.end(),
+                 static_cast<const char*>(data.getData())))
+    return state_format::read(data.getData(), data.getSize(), preset);
+
+  return readJsonPreset(data.toString(), preset);
+}
+
+// All tracks merged, with timestamps in seconds
+juce::Result readMidi(const juce::File& file, juce::MidiMessageSequence& midi) {
+  if (file == juce::File{})
+    return juce::Result::ok();
+
+  juce::FileInputStream stream{file};
+  juce::MidiFile midiFile;
+  if (stream.failedToOpen() || !midiFile.readFrom(stream))
+    return juce::Result::fail("Could not read " + file.getFullPathName());
+
+  midiFile.convertTimestampTicksToSeconds();
+  for (auto track = 0; track < midiFile.getNumTracks(); ++track) {
+    midi.addSequence(*midiFile.getTrack(track), 0.0);
+  }
+  midi.sort();
+  return juce::Result::ok();
+}
+
+/**
+ * @brief One worker of the pool: a processor instance and a background thread
+ * for its disk I/O, reused for every file the worker takes.
+ */
+class Worker {
+public:
+  Worker(int workerIndex,
+         const Options& renderOptions,
+         const ProcessorState& preset,
+         const juce::MidiMessageSequence& midiSequence)
+      : index{workerIndex}, options{renderOptions}, midi{midiSequence} {
+    formatManager.registerBasicFormats();
+    processor.restoreState(preset);
+    midiBuffer.ensureSize(4096);
+    ioThread.startThread();
+  }
+
+  ~Worker() { ioThread.stopThread(1000); }
+
+  FileResult render(const juce::File& input) {
+    FileResult result{.input = input, .worker = index};
+    const auto start = juce::Time::getHighResolutionTicks();
+    result.error = render(input, result).getErrorMessage();
+    result.wallSeconds = juce::Time::highResolutionTicksToSeconds(
+        juce::Time::getHighResolutionTicks() - start);
+    return result;
+  }
+
+private:
+  juce::Result render(const juce::File& input, FileResult& result) {
+    auto* format = formatManager.findFormatForFileExtension(
+        input.getFileExtension());
+    std::unique_ptr<juce::AudioFormatReader> fileReader{
+        format != nullptr
+            ? format->createReaderFor(new juce::FileInputStream{input}, true)
+            : nullptr};
+    if (fileReader == nullptr)
+      return juce::Result::fail("Could not read " + input.getFullPathName());
+
+    const auto numChannels = static_cast<int>(fileReader->numChannels);
+    const auto sampleRate = fileReader->sampleRate;
+    const auto length = fileReader->lengthInSamples;
+    const auto blockSize = options.blockSize;
+    result.numChannels = numChannels;
+    result.sampleRate = sampleRate;
+    result.numSamples = length;
+
+    juce::AudioProcessor::BusesLayout layout;
+    layout.inputBuses.add(getChannelLayout(numChannels));
+    layout.outputBuses.add(getChannelLayout(numChannels));
+    if (!processor.setBusesLayout(layout))
+      return juce::Result::fail("Unsupported layout of " +
+                                juce::String{numChannels} + " channels");
+
+    result.output = options.outputDirectory.getChildFile(input.getFileName());
+    if (result.output == input)
+      return juce::Result::fail("The output would overwrite the input");
+
+    // Replace the output only once it's complete
+    juce::TemporaryFile temporaryFile{result.output};
+    {
+      auto stream =
+          std::make_unique<juce::FileOutputStream>(temporaryFile.getFile());
+      const auto bitDepth = getBitDepth(*format, fileReader->bitsPerSample);
+      std::unique_ptr<juce::AudioFormatWriter> fileWriter{
+          stream->failedToOpen()
+              ? nullptr
+              : format->createWriterFor(stream.get(), sampleRate,
+                                        static_cast<unsigned int>(numChannels),
+                                        bitDepth, fileReader->metadataValues,
+                                        0)};
+      if (fileWriter == nullptr)
+        return juce::Result::fail("Could not write " +
+                                  result.output.getFullPathName());
+      // Owned by the writer from now on
+      stream.release();
+
+      // Read ahead and written behind on the I/O thread
+      juce::BufferingAudioReader reader{fileReader.release(), ioThread,
+                                        NUM_BUFFERED_BLOCKS * blockSize};
+      reader.setReadTimeout(-1);
+      juce::AudioFormatWriter::ThreadedWriter writer{
+          fileWriter.release(), ioThread, NUM_BUFFERED_BLOCKS * blockSize};
+
+      processor.setRateAndBufferSizeDetails(sampleRate, blockSize);
+      processor.prepareToPlay(sampleRate, blockSize);
+      buffer.setSize(numChannels, blockSize, false, false, true);
+
+      // The first latency samples are dropped and as many samples past the
+      // end of the input are rendered instead
+      const auto latency = processor.getLatencySamples();
+      const auto totalSamples = length + latency;
+      auto nextMidiEvent = 0;
+      juce::int64 processTicks = 0;
+
+      for (juce::int64 blockStart = 0; blockStart < totalSamples;
+           blockStart += blockSize) {
+        const auto numSamples = static_cast<int>(
+            std::min<juce::int64>(blockSize, totalSamples - blockStart));
+        const auto numInputSamples = static_cast<int>(std::clamp<juce::int64>(
+            length - blockStart, 0, numSamples));
+
+        buffer.clear();
+        if (numInputSamples > 0 &&
+            !reader.read(buffer.getArrayOfWritePointers(), numChannels,
+                         blockStart, numInputSamples))
+          return juce::Result::fail("Could not read " +
+                                    input.getFullPathName());
+
+        fillMidi(nextMidiEvent, blockStart, numSamples, sampleRate);
+
+        // The last block may be shorter
+        auto blockBuffer = juce::AudioBuffer<float>{
+            buffer.getArrayOfWritePointers(), numChannels, numSamples};
+        const auto processStart = juce::Time::getHighResolutionTicks();
+        processor.processBlock(blockBuffer, midiBuffer);
+        processTicks += juce::Time::getHighResolutionTicks() - processStart;
+
+        const auto skipped = static_cast<int>(std::clamp<juce::int64>(
+            latency - blockStart, 0, numSamples));
+        if (skipped < numSamples)
+          write(writer, skipped, numSamples - skipped);
+      }
+
+      processor.releaseResources();
+      result.processSeconds =
+          juce::Time::highResolutionTicksToSeconds(processTicks);
+      // Destroying the writer flushes what is left
+    }
+
+    if (!temporaryFile.overwriteTargetFileWithTemporary())
+      return juce::Result::fail("Could not write " +
+                                result.output.getFullPathName());
+
+    return juce::Result::ok();
+  }
+
+  // The input's bit depth if the format can write it, else its highest one
+  static int getBitDepth(juce::AudioFormat& format, unsigned int inputBitDepth) {
+    const auto bitDepths = format.getPossibleBitDepths();
+    if (bitDepths.contains(static_cast<int>(inputBitDepth)))
+      return static_cast<int>(inputBitDepth);
+    return bitDepths.isEmpty() ? 24 : bitDepths.getLast();
+  }
+
+  void fillMidi(int& nextEvent,
+                juce::int64 blockStart,
+                int numSamples,
+                double sampleRate) {
+    midiBuffer.clear();
+
+    const auto blockEnd = blockStart + numSamples;
+    for (; nextEvent < midi.getNumEvents(); ++nextEvent) {
+      const auto& message = midi.getEventPointer(nextEvent)->message;
+      const auto position = static_cast<juce::int64>(
+          std::llround(message.getTimeStamp() * sampleRate));
+      if (position >= blockEnd)
+        break;
+      if (!message.isMetaEvent())
+        midiBuffer.addEvent(
+            message,
+            static_cast<int>(std::max<juce::int64>(position - blockStart, 0)));
+    }
+  }
+
+  void write(juce::AudioFormatWriter::ThreadedWriter& writer,
+             int start,
+             int numSamples) {
+    channelPointers.clear();
+    for (auto channel = 0; channel < buffer.getNumChannels(); ++channel) {
+      channelPointers.push_back(buffer.getReadPointer(channel, start));
+    }
+    channelPointers.push_back(nullptr);
+
+    // The FIFO is full when the disk can't keep up: wait for it to drain
+    while (!writer.write(channelPointers.data(), numSamples)) {
+      juce::Thread::sleep(1);
+    }
+  }
+
+  const int index;
+  const Options& options;
+  const juce::MidiMessageSequence& midi;
+  juce::AudioFormatManager formatManager;
+  AudioPluginAudioProcessor processor;
+  juce::TimeSliceThread ioThread{"Renderer I/O"};
+  juce::AudioBuffer<float> buffer;
+  juce::MidiBuffer midiBuffer;
+  std::vector<const float*> channelPointers;
+};
+
+juce::var toVar(const FileResult& result) {
+  const auto audioSeconds =
+      result.sampleRate > 0.0
+          ? static_cast<double>(result.numSamples) / result.sampleRate
+          : 0.0;
+
+  juce::DynamicObject::Ptr object{new juce::DynamicObject{}};
+  object->setProperty("input", result.input.getFullPathName());
+  object->setProperty("output", result.output.getFullPathName());
+  if (result.error.isNotEmpty())
+    object->setProperty("error", result.error);
+  object->setProperty("worker", result.worker);
+  object->setProperty("channels", result.numChannels);
+  object->setProperty("sampleRate", result.sampleRate);
+  object->setProperty("samples", result.numSamples);
+  object->setProperty("audioSeconds", audioSeconds);
+  object->setProperty("wallSeconds", result.wallSeconds);
+  object->setProperty("processSeconds", result.processSeconds);
+  object->setProperty("realtimeFactor", result.wallSeconds > 0.0
+                                            ? audioSeconds / result.wallSeconds
+                                            : 0.0);
+  return juce::var{object.get()};
+}
+
+int runRenderer(const juce::ArgumentList& arguments) {
+  juce::AudioFormatManager formatManager;
+  formatManager.registerBasicFormats();
+  const auto wildcard = formatManager.getWildcardForAllFormats();
+
+  const auto options = parseOptions(arguments, wildcard);
+
+  if (arguments.containsOption("--help|-h") || options.inputFiles.isEmpty() ||
+      options.outputDirectory == juce::File{}) {
+    std::cout << "Usage: " << arguments.executableName
+              << " --output-dir=rendered [--preset=preset.json]"
+                 " [--midi=notes.mid] [--threads=8] [--block-size=4096]"
+                 " [--report=report.json] input.wav stems/ ..."
+              << std::endl;
+    return arguments.containsOption("--help|-h") ? 0 : 1;
+  }
+
+  ProcessorState preset;
+  if (const auto result = readPreset(options.presetFile, preset);
+      result.failed()) {
+    std::cerr << result.getErrorMessage() << std::endl;
+    return 1;
+  }
+
+  juce::MidiMessageSequence midi;
+  if (const auto result = readMidi(options.midiFile, midi); result.failed()) {
+    std::cerr << result.getErrorMessage() << std::endl;
+    return 1;
+  }
+
+  if (const auto result = options.outputDirectory.createDirectory();
+      result.failed()) {
+    std::cerr << result.getErrorMessage() << std::endl;
+    return 1;
+  }
+
+  // Workers take the next file as soon as they are done with one, so long
+  // and short files balance out
+  const auto numThreads =
+      juce::jmin(options.numThreads, options.inputFiles.size());
+  std::vector<FileResult> results(
+      static_cast<size_t>(options.inputFiles.size()));
+  std::atomic<int> nextFile{0};
+  std::mutex outputLock;
+
+  const auto start = juce::Time::getHighResolutionTicks();
+  std::vector<std::thread> threads;
+  for (auto index = 0; index < numThreads; ++index) {
+    threads.emplace_back([&, index] {
+      Worker worker{index, options, preset, midi};
+
+      for (auto file = nextFile++; file < options.inputFiles.size();
+           file = nextFile++) {
+        auto& result = results[static_cast<size_t>(file)] =
+            worker.render(options.inputFiles[file]);
+
+        const std::scoped_lock lock{outputLock};
+        std::cerr << result.input.getFileName() << ": "
+                  << (result.error.isEmpty()
+                          ? juce::String{result.wallSeconds, 2} + " s"
+                          : result.error)
+                  << std::endl;
+      }
+    });
+  }
+
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  const auto wallSeconds = juce::Time::highResolutionTicksToSeconds(
+      juce::Time::getHighResolutionTicks() - start);
+
+  auto numFailed = 0;
+  auto audioSeconds = 0.0;
+  auto processSeconds = 0.0;
+  juce::Array<juce::var> files;
+  for (const auto& result : results) {
+    files.add(toVar(result));
+    if (result.error.isNotEmpty()) {
+      ++numFailed;
+    } else {
+      audioSeconds += static_cast<double>(result.numSamples) / result.sampleRate;
+      processSeconds += result.processSeconds;
+    }
+  }
+
+  const auto realtimeFactor =
+      wallSeconds > 0.0 ? audioSeconds / wallSeconds : 0.0;
+  std::cerr << results.size() - static_cast<size_t>(numFailed)
+            << " files rendered, " << numFailed << " failed, "
+            << audioSeconds << " s of audio in " << wallSeconds << " s on "
+            << numThreads << " threads: " << realtimeFactor << "x realtime"
+            << std::endl;
+
+  juce::DynamicObject::Ptr report{new juce::DynamicObject{}};
+  report->setProperty("threads", numThreads);
+  report->setProperty("blockSize", options.blockSize);
+  report->setProperty("failed", numFailed);
+  report->setProperty("audioSeconds", audioSeconds);
+  report->setProperty("wallSeconds", wallSeconds);
+  report->setProperty("processSeconds", processSeconds);
+  report->setProperty("realtimeFactor", realtimeFactor);
+  // How much of the ideal speed-up over a single thread the pool reached
+  report->setProperty("parallelEfficiency",
+                      wallSeconds > 0.0
+                          ? processSeconds / (wallSeconds * numThreads)
+                          : 0.0);
+  report->setProperty("files", files);
+#if JUCE_DEBUG
+  report->setProperty("build", "debug");
+#else
+  report->setProperty("build", "release");
+#endif
+
+  const auto json = juce::JSON::toString(juce::var{report.get()});
+  if (options.reportFile == juce::File{}) {
+    std::cout << json << std::endl;
+  } else if (!options.reportFile.replaceWithText(json)) {
+    std::cerr << "Could not write " << options.reportFile.getFullPathName()
+              << std::endl;
+    return 1;
+  }
+
+  return numFailed == 0 ? 0 : 1;
+}
+}  // namespace
+}  // namespace webview_plugin::renderer
+
+int main(int argc, char* argv[]) {
+  // The processor relies on the message manager, e.g., for async updates
+  const juce::ScopedJuceInitialiser_GUI juceInitialiser;
+  return webview_plugin::renderer::runRenderer(juce::ArgumentList{argc, argv});
+}
@@ -0,0 +1,61 @@
+#include "JuceWebViewTutorial/ActiveNoteTracker.h"
+#include <algorithm>
+
+namespace webview_plugin {
+void ActiveNoteTracker::prepare() {
+  constexpr auto NUM_SLOTS = static_cast<std::size_t>(NUM_CHANNELS * NUM_NOTES);
+  slots.resize(NUM_SLOTS);
+  referenceCounts.resize(NUM_SLOTS);
+  reset();
+}
+
+void ActiveNoteTracker::reset() noexcept {
+  std::fill(slots.begin(), slots.end(), Slot{});
+  std::fill(referenceCounts.begin(), referenceCounts.end(), std::uint16_t{0});
+}
+
+void ActiveNoteTracker::addHarmonic(int channel,
+                                    int rootNote,
+                                    int harmonicNote) noexcept {
+  if (!isPrepared())
+    return;
+
+  auto& slot = getSlot(channel, rootNote);
+  if (!slot.active || slot.numHarmonics == slot.harmonics.size())
+    return;
+
+  slot.harmonics[slot.numHarmonics++] = static_cast<std::uint8_t>(harmonicNote);
+  ++referenceCount(channel, harmonicNote);
+}
+
+bool ActiveNoteTracker::releaseRoot(int channel, int rootNote) noexcept {
+  // Note-offs for notes we have never seen are forwarded untouched
+  if (!isPrepared() || referenceCount(channel, rootNote) == 0)
+    return true;
+
+  return release(channel, rootNote);
+}
+
+void ActiveNoteTracker::resetChannel(int channel) noexcept {
+  if (!isPrepared())
+    return;
+
+  const auto first = static_cast<std::ptrdiff_t>(indexOf(channel, 0));
+  std::fill_n(slots.begin() + first, NUM_NOTES, Slot{});
+  std::fill_n(referenceCounts.begin() + first, NUM_NOTES, std::uint16_t{0});
+}
+
+int ActiveNoteTracker::getNumSoundingNotes() const noexcept {
+  return static_cast<int>(
+      std::count_if(referenceCounts.begin(), referenceCounts.end(),
+                    [](auto count) { return count > 0; }));
+}
+
+bool ActiveNoteTracker::release(int channel, int note) noexcept {
+  auto& count = referenceCount(channel, note);
+  if (count == 0)
+    return false;
+
+  return --count == 0;
+}
+}  // namespace webview_plugin
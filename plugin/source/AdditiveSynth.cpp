@@ -0,0 +1,315 @@
+#include "JuceWebViewTutorial/AdditiveSynth.h"
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <numeric>
+
+namespace webview_plugin {
+PartialPlan PartialPlan::compile(const HarmonicTable& table) {
+  PartialPlan plan;
+
+  for (auto h = 0; h < table.size; ++h) {
+    const auto index = static_cast<size_t>(h);
+    // Convert 0-100 to 0-1
+    const auto normalizedValue = table.values[index] / 100.f;
+    plan.amplitudes[index] = normalizedValue;
+
+    if (normalizedValue > AUDIBILITY_THRESHOLD) {
+      plan.partials[static_cast<size_t>(plan.size++)] = {
+          .harmonic = h + 1, .amplitude = normalizedValue};
+    }
+  }
+
+  return plan;
+}
+
+void AdditiveSynth::prepare(double newSampleRate, int maxBlockSize) {
+  sampleRate = newSampleRate;
+
+  constexpr auto size = static_cast<size_t>(MAX_VOICES * MAX_PARTIALS);
+  real.assign(size, 0.f);
+  imaginary.assign(size, 0.f);
+  cosines.assign(size, 1.f);
+  sines.assign(size, 0.f);
+  amplitudes.assign(size, 0.f);
+  amplitudeSteps.assign(size, 0.f);
+  harmonics.assign(size, 0);
+  scratch.assign(static_cast<size_t>(juce::jmax(1, maxBlockSize)), 0.f);
+
+  reset();
+}
+
+void AdditiveSynth::reset() noexcept {
+  stages.fill(Stage::idle);
+  gains.fill(0.f);
+  rampSamplesLeft.fill(0);
+  numPartials.fill(0);
+  numPaddedPartials.fill(0);
+  amplitudeRampPending.fill(false);
+}
+
+void AdditiveSynth::setPlan(const PartialPlan& newPlan) noexcept {
+  plan = newPlan;
+
+  for (size_t voice = 0; voice < MAX_VOICES; ++voice) {
+    if (stages[voice] != Stage::idle)
+      amplitudeRampPending[voice] = true;
+  }
+}
+
+void AdditiveSynth::handleMidiEvent(const juce::MidiMessage& message) noexcept {
+  if (message.isNoteOn()) {
+    startVoice(message.getNoteNumber(), message.getFloatVelocity());
+  } else if (message.isNoteOff()) {
+    releaseVoices(message.getNoteNumber());
+  } else if (message.isAllNotesOff() || message.isAllSoundOff()) {
+    releaseAllVoices();
+  }
+}
+
+void AdditiveSynth::render(juce::dsp::AudioBlock<float> block) noexcept {
+  if (getNumActiveVoices() == 0)
+    return;
+
+  // Rendered in chunks that fit the scratch buffer, then added to every
+  // channel
+  const auto maxChunkSize = scratch.size();
+  for (size_t start = 0; start < block.getNumSamples(); start += maxChunkSize) {
+    const auto chunkSize =
+        static_cast<int>(std::min(maxChunkSize, block.getNumSamples() - start));
+    std::fill_n(scratch.begin(), chunkSize, 0.f);
+    render(scratch.data(), chunkSize);
+
+    for (size_t channel = 0; channel < block.getNumChannels(); ++channel) {
+      juce::FloatVectorOperations::add(
+          block.getChannelPointer(channel) + start, scratch.data(), chunkSize);
+    }
+  }
+}
+
+void AdditiveSynth::render(float* output, int numSamples) noexcept {
+  for (size_t voice = 0; voice < MAX_VOICES; ++voice) {
+    if (stages[voice] != Stage::idle)
+      renderVoice(voice, output, numSamples);
+  }
+}
+
+int AdditiveSynth::getNumActiveVoices() const noexcept {
+  return static_cast<int>(
+      std::count_if(stages.begin(), stages.end(),
+                    [](Stage stage) { return stage != Stage::idle; }));
+}
+
+int AdditiveSynth::getNumActivePartials() const noexcept {
+  auto result = 0;
+  for (size_t voice = 0; voice < MAX_VOICES; ++voice) {
+    if (stages[voice] != Stage::idle)
+      result += numPartials[voice];
+  }
+  return result;
+}
+
+void AdditiveSynth::startVoice(int note, float velocity) noexcept {
+  const auto voice = static_cast<size_t>(findVoiceToStart());
+  const auto offset = getPartialOffset(voice);
+  const auto fundamental = juce::MidiMessage::getMidiNoteInHertz(note);
+  const auto nyquist = 0.5 * sampleRate;
+
+  // Rotations by integer multiples of the fundamental's phase increment are
+  // powers of its rotation: no trigonometry per partial
+  const auto increment =
+      juce::MathConstants<double>::twoPi * fundamental / sampleRate;
+  const std::complex<double> rotation{std::cos(increment),
+                                      std::sin(increment)};
+  std::complex<double> harmonicRotation{1.0, 0.0};
+  auto harmonic = 0;
+
+  auto count = 0;
+  for (auto i = 0; i < plan.size; ++i) {
+    const auto& partial = plan.partials[static_cast<size_t>(i)];
+
+    // Partials are sorted: all further ones would alias as well
+    if (partial.harmonic * fundamental >= nyquist)
+      break;
+
+    while (harmonic < partial.harmonic) {
+      harmonicRotation *= rotation;
+      ++harmonic;
+    }
+
+    const auto index = offset + static_cast<size_t>(count++);
+    real[index] = 1.f;
+    imaginary[index] = 0.f;
+    cosines[index] = static_cast<float>(harmonicRotation.real());
+    sines[index] = static_cast<float>(harmonicRotation.imag());
+    amplitudes[index] = partial.amplitude;
+    amplitudeSteps[index] = 0.f;
+    harmonics[index] = static_cast<std::uint8_t>(partial.harmonic);
+  }
+
+  // Silent padding up to whole lanes
+  const auto numPadded = (count + LANES - 1) / LANES * LANES;
+  for (auto i = count; i < numPadded; ++i) {
+    const auto index = offset + static_cast<size_t>(i);
+    real[index] = 0.f;
+    imaginary[index] = 0.f;
+    amplitudes[index] = 0.f;
+    amplitudeSteps[index] = 0.f;
+  }
+
+  numPartials[voice] = count;
+  numPaddedPartials[voice] = numPadded;
+  notes[voice] = note;
+  velocities[voice] = velocity;
+  startOrder[voice] = voiceCounter++;
+  stages[voice] = Stage::attack;
+  amplitudeRampPending[voice] = false;
+  gains[voice] = 0.f;
+  startRamp(voice, velocity * OUTPUT_GAIN, ATTACK_SECONDS);
+}
+
+void AdditiveSynth::releaseVoices(int note) noexcept {
+  for (size_t voice = 0; voice < MAX_VOICES; ++voice) {
+    if (notes[voice] == note &&
+        (stages[voice] == Stage::attack || stages[voice] == Stage::sustain)) {
+      stages[voice] = Stage::release;
+      startRamp(voice, 0.f, RELEASE_SECONDS);
+    }
+  }
+}
+
+void AdditiveSynth::releaseAllVoices() noexcept {
+  for (size_t voice = 0; voice < MAX_VOICES; ++voice) {
+    if (stages[voice] == Stage::attack || stages[voice] == Stage::sustain) {
+      stages[voice] = Stage::release;
+      startRamp(voice, 0.f, RELEASE_SECONDS);
+    }
+  }
+}
+
+int AdditiveSynth::findVoiceToStart() const noexcept {
+  const auto idle = std::find(stages.begin(), stages.end(), Stage::idle);
+  if (idle != stages.end())
+    return static_cast<int>(std::distance(stages.begin(), idle));
+
+  // Steal the oldest released voice, or else the oldest one. Start orders
+  // are compared relative to the counter, so that wrapping doesn't matter.
+  auto oldest = 0;
+  auto oldestAge = 0u;
+  auto isOldestReleased = false;
+
+  for (auto voice = 0; voice < MAX_VOICES; ++voice) {
+    const auto index = static_cast<size_t>(voice);
+    const auto age = voiceCounter - startOrder[index];
+    const auto isReleased = stages[index] == Stage::release;
+
+    if ((isReleased && !isOldestReleased) ||
+        (isReleased == isOldestReleased && age > oldestAge)) {
+      oldest = voice;
+      oldestAge = age;
+      isOldestReleased = isReleased;
+    }
+  }
+
+  return oldest;
+}
+
+void AdditiveSynth::startRamp(size_t voice,
+                              float target,
+                              double seconds) noexcept {
+  const auto numSamples = juce::jmax(1, juce::roundToInt(seconds * sampleRate));
+  gainSteps[voice] = (target - gains[voice]) / static_cast<float>(numSamples);
+  rampSamplesLeft[voice] = numSamples;
+}
+
+void AdditiveSynth::renderVoice(size_t voice,
+                                float* output,
+                                int numSamples) noexcept {
+  const auto offset = getPartialOffset(voice);
+  auto* re = real.data() + offset;
+  auto* im = imaginary.data() + offset;
+  const auto* c = cosines.data() + offset;
+  const auto* s = sines.data() + offset;
+  auto* a = amplitudes.data() + offset;
+  auto* da = amplitudeSteps.data() + offset;
+  const auto numPadded = numPaddedPartials[voice];
+
+  // A new plan: glide to its amplitudes over this call
+  if (amplitudeRampPending[voice] && numSamples > 0) {
+    for (auto k = 0; k < numPartials[voice]; ++k) {
+      const auto target = plan.amplitudes[static_cast<size_t>(
+          harmonics[offset + static_cast<size_t>(k)] - 1)];
+      da[k] = (target - a[k]) / static_cast<float>(numSamples);
+    }
+  }
+
+  auto gain = gains[voice];
+  auto gainStep = gainSteps[voice];
+  auto samplesLeft = rampSamplesLeft[voice];
+
+  for (auto i = 0; i < numSamples; ++i) {
+    // One partial sum per lane, so that the loop below needs no horizontal
+    // additions
+    std::array<float, LANES> sums{};
+
+    for (auto p = 0; p < numPadded; p += LANES) {
+      for (auto lane = 0; lane < LANES; ++lane) {
+        const auto k = p + lane;
+        const auto x = re[k];
+        const auto y = im[k];
+        re[k] = x * c[k] - y * s[k];
+        im[k] = x * s[k] + y * c[k];
+        a[k] += da[k];
+        sums[static_cast<size_t>(lane)] += a[k] * y;
+      }
+    }
+
+    output[i] += gain * std::accumulate(sums.begin(), sums.end(), 0.f);
+
+    if (samplesLeft > 0) {
+      gain += gainStep;
+      --samplesLeft;
+    }
+  }
+
+  if (amplitudeRampPending[voice] && numSamples > 0) {
+    // Land exactly on the targets
+    for (auto k = 0; k < numPartials[voice]; ++k) {
+      a[k] = plan.amplitudes[static_cast<size_t>(
+          harmonics[offset + static_cast<size_t>(k)] - 1)];
+      da[k] = 0.f;
+    }
+    amplitudeRampPending[voice] = false;
+  }
+
+  // Keep the phasors on the unit circle: one Newton step towards
+  // 1 / sqrt(|z|^2) suffices for the tiny drift of one call
+  for (auto k = 0; k < numPadded; ++k) {
+    const auto scale = 1.5f - 0.5f * (re[k] * re[k] + im[k] * im[k]);
+    re[k] *= scale;
+    im[k] *= scale;
+  }
+
+  rampSamplesLeft[voice] = samplesLeft;
+  if (samplesLeft > 0) {
+    gains[voice] = gain;
+    return;
+  }
+
+  // The ramp has ended: settle on its target
+  switch (stages[voice]) {
+    case Stage::attack:
+      gains[voice] = velocities[voice] * OUTPUT_GAIN;
+      stages[voice] = Stage::sustain;
+      break;
+    case Stage::release:
+      gains[voice] = 0.f;
+      stages[voice] = Stage::idle;
+      break;
+    case Stage::sustain:
+    case Stage::idle:
+      gains[voice] = gain;
+      break;
+  }
+}
+}  // namespace webview_plugin
@@ -0,0 +1,259 @@
+#include "JuceWebViewTutorial/AssetBundle.h"
+#include <algorithm>
+#include <iterator>
+#include <limits>
+#include <unordered_map>
+
+namespace webview_plugin::asset_bundle {
+namespace {
+struct PackedFile {
+  juce::String path;
+  juce::String mimeType;
+  juce::MemoryBlock data;
+  ManifestEntry entry;
+};
+
+size_t align(size_t offset) noexcept {
+  return (offset + DATA_ALIGNMENT - 1) / DATA_ALIGNMENT * DATA_ALIGNMENT;
+}
+
+bool isExcluded(const juce::File& file, const PackOptions& options) {
+  return std::any_of(options.excludedFiles.begin(), options.excludedFiles.end(),
+                     [&file](const auto& wildcard) {
+                       return file.getFileName().matchesWildcard(wildcard,
+                                                                 true);
+                     });
+}
+
+juce::MemoryBlock compress(const juce::MemoryBlock& contents) {
+  juce::MemoryBlock compressed;
+  {
+    juce::MemoryOutputStream memoryStream{compressed, false};
+    juce::GZIPCompressorOutputStream zlibStream{memoryStream, 9};
+    zlibStream.write(contents.getData(), contents.getSize());
+  }
+  return compressed;
+}
+
+PackedFile packFile(const juce::File& directory,
+                    const juce::File& file,
+                    const PackOptions& options) {
+  PackedFile packed;
+  packed.path =
+      file.getRelativePathFrom(directory).replaceCharacter('\\', '/');
+  packed.mimeType =
+      getMimeForExtension(file.getFileExtension().trimCharactersAtStart("."));
+  file.loadFileAsData(packed.data);
+
+  auto& entry = packed.entry;
+  entry.pathHash = hashPath(packed.path);
+  entry.contentHash = hash(static_cast<const char*>(packed.data.getData()),
+                           packed.data.getSize());
+  entry.size = static_cast<std::uint32_t>(packed.data.getSize());
+
+  if (packed.data.getSize() >= options.minCompressedSize) {
+    auto compressed = compress(packed.data);
+    const auto ratio = static_cast<double>(compressed.getSize()) /
+                       static_cast<double>(packed.data.getSize());
+    if (ratio <= options.maxCompressionRatio) {
+      packed.data = std::move(compressed);
+      entry.codec = Codec::zlib;
+    }
+  }
+
+  entry.storedSize = static_cast<std::uint32_t>(packed.data.getSize());
+  return packed;
+}
+
+void writeEntry(juce::OutputStream& output, const ManifestEntry& entry) {
+  output.writeInt64(static_cast<juce::int64>(entry.pathHash));
+  output.writeInt64(static_cast<juce::int64>(entry.contentHash));
+  for (const auto value :
+       {entry.pathOffset, entry.pathLength, entry.mimeTypeOffset,
+        entry.mimeTypeLength, entry.dataOffset, entry.storedSize, entry.size,
+        static_cast<std::uint32_t>(entry.codec)}) {
+    output.writeInt(static_cast<int>(value));
+  }
+}
+
+ManifestEntry readEntry(juce::InputStream& input) {
+  ManifestEntry entry;
+  entry.pathHash = static_cast<std::uint64_t>(input.readInt64());
+  entry.contentHash = static_cast<std::uint64_t>(input.readInt64());
+  for (auto* value :
+       {&entry.pathOffset, &entry.pathLength, &entry.mimeTypeOffset,
+        &entry.mimeTypeLength, &entry.dataOffset, &entry.storedSize,
+        &entry.size}) {
+    *value = static_cast<std::uint32_t>(input.readInt());
+  }
+  entry.codec = static_cast<Codec>(input.readInt());
+  return entry;
+}
+}  // namespace
+
+juce::Result pack(const juce::File& directory,
+                  juce::OutputStream& output,
+                  PackStatistics& statistics,
+                  const PackOptions& options) {
+  statistics = {};
+
+  if (!directory.isDirectory())
+    return juce::Result::fail("Not a directory: " +
+                              directory.getFullPathName());
+
+  std::vector<PackedFile> files;
+  for (const auto& entry : juce::RangedDirectoryIterator{
+           directory, true, "*", juce::File::findFiles}) {
+    if (isExcluded(entry.getFile(), options)) {
+      ++statistics.numExcludedFiles;
+      continue;
+    }
+
+    files.push_back(packFile(directory, entry.getFile(), options));
+    statistics.inputBytes += files.back().entry.size;
+  }
+
+  std::sort(files.begin(), files.end(), [](const auto& a, const auto& b) {
+    return a.entry.pathHash < b.entry.pathHash;
+  });
+
+  if (const auto duplicate = std::adjacent_find(
+          files.begin(), files.end(),
+          [](const auto& a, const auto& b) {
+            return a.entry.pathHash == b.entry.pathHash;
+          });
+      duplicate != files.end())
+    return juce::Result::fail("Path hash collision: " + duplicate->path +
+                              " and " + std::next(duplicate)->path);
+
+  // Lay out the string table and the data
+  juce::MemoryOutputStream strings;
+  const auto stringTableOffset =
+      HEADER_SIZE + MANIFEST_ENTRY_SIZE * files.size();
+
+  for (auto& file : files) {
+    file.entry.pathOffset =
+        static_cast<std::uint32_t>(stringTableOffset + strings.getDataSize());
+    file.entry.pathLength =
+        static_cast<std::uint32_t>(file.path.getNumBytesAsUTF8());
+    strings.write(file.path.toRawUTF8(), file.entry.pathLength);
+
+    file.entry.mimeTypeOffset =
+        static_cast<std::uint32_t>(stringTableOffset + strings.getDataSize());
+    file.entry.mimeTypeLength =
+        static_cast<std::uint32_t>(file.mimeType.getNumBytesAsUTF8());
+    strings.write(file.mimeType.toRawUTF8(), file.entry.mimeTypeLength);
+  }
+
+  auto dataOffset = align(stringTableOffset + strings.getDataSize());
+  for (auto& file : files) {
+    file.entry.dataOffset = static_cast<std::uint32_t>(dataOffset);
+    dataOffset = align(dataOffset + file.data.getSize());
+  }
+
+  if (dataOffset > std::numeric_limits<std::uint32_t>::max())
+    return juce::Result::fail("Web UI files exceed 4 GiB");
+
+  // Write everything out
+  const auto start = output.getPosition();
+  const auto pad = [&output, start] {
+    const auto position = static_cast<size_t>(output.getPosition() - start);
+    output.writeRepeatedByte(0, align(position) - position);
+  };
+
+  output.write(MAGIC.data(), MAGIC.size());
+  output.writeInt(static_cast<int>(VERSION));
+  output.writeInt(static_cast<int>(files.size()));
+  output.writeInt(0);
+
+  for (const auto& file : files) {
+    writeEntry(output, file.entry);
+  }
+
+  output << strings.getMemoryBlock();
+
+  for (const auto& file : files) {
+    pad();
+    output << file.data;
+    statistics.numCompressedFiles += file.entry.codec == Codec::zlib ? 1 : 0;
+  }
+
+  statistics.numFiles = static_cast<int>(files.size());
+  statistics.bundleBytes = static_cast<size_t>(output.getPosition() - start);
+  return juce::Result::ok();
+}
+
+juce::Result readManifest(const void* bundle,
+                          size_t bundleSize,
+                          std::vector<ManifestEntry>& entries) {
+  entries.clear();
+
+  juce::MemoryInputStream input{bundle, bundleSize, false};
+  std::array<char, 4> magic{};
+
+  if (bundleSize < HEADER_SIZE ||
+      input.read(magic.data(), magic.size()) !=
+          static_cast<int>(magic.size()) ||
+      magic != MAGIC)
+    return juce::Result::fail("Not a web UI bundle");
+
+  if (const auto version = static_cast<std::uint32_t>(input.readInt());
+      version != VERSION)
+    return juce::Result::fail("Unsupported bundle version " +
+                              juce::String{version});
+
+  const auto numEntries = static_cast<std::uint32_t>(input.readInt());
+  input.setPosition(static_cast<juce::int64>(HEADER_SIZE));
+
+  if (HEADER_SIZE + MANIFEST_ENTRY_SIZE * numEntries > bundleSize)
+    return juce::Result::fail("Truncated bundle manifest");
+
+  entries.reserve(numEntries);
+  for (auto i = 0u; i < numEntries; ++i) {
+    const auto entry = readEntry(input);
+    const auto inBounds = [bundleSize](std::uint32_t offset,
+                                       std::uint32_t length) {
+      return static_cast<size_t>(offset) + length <= bundleSize;
+    };
+
+    if (!inBounds(entry.pathOffset, entry.pathLength) ||
+        !inBounds(entry.mimeTypeOffset, entry.mimeTypeLength) ||
+        !inBounds(entry.dataOffset, entry.storedSize) ||
+        (entry.codec != Codec::stored && entry.codec != Codec::zlib) ||
+        (entry.codec == Codec::stored && entry.storedSize != entry.size) ||
+        (!entries.empty() && entries.back().pathHash >= entry.pathHash)) {
+      entries.clear();
+      return juce::Result::fail("Corrupt bundle manifest entry " +
+                                juce::String{i});
+    }
+
+    entries.push_back(entry);
+  }
+
+  return juce::Result::ok();
+}
+
+const char* getMimeForExtension(const juce::String& extension) {
+  static const std::unordered_map<juce::String, const char*> mimeMap = {
+      {{"htm"}, "text/html"},
+      {{"html"}, "text/html"},
+      {{"txt"}, "text/plain"},
+      {{"jpg"}, "image/jpeg"},
+      {{"jpeg"}, "image/jpeg"},
+      {{"svg"}, "image/svg+xml"},
+      {{"ico"}, "image/vnd.microsoft.icon"},
+      {{"json"}, "application/json"},
+      {{"png"}, "image/png"},
+      {{"css"}, "text/css"},
+      {{"map"}, "application/json"},
+      {{"js"}, "text/javascript"},
+      {{"mjs"}, "text/javascript"},
+      {{"woff2"}, "font/woff2"}};
+
+  if (const auto it = mimeMap.find(extension.toLowerCase());
+      it != mimeMap.end())
+    return it->second;
+
+  return "application/octet-stream";
+}
+}  // namespace webview_plugin::asset_bundle
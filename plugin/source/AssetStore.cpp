@@ -0,0 +1,88 @@
+#include "JuceWebViewTutorial/AssetStore.h"
+#include <algorithm>
+#include <cstring>
+
+namespace webview_plugin {
+AssetStore::AssetStore(const void* bundleData, size_t bundleDataSize)
+    : bundle{static_cast<const std::byte*>(bundleData)},
+      bundleSize{bundleDataSize} {
+  [[maybe_unused]] const auto result =
+      asset_bundle::readManifest(bundleData, bundleSize, manifest);
+  jassert(result.wasOk());
+
+  for (const auto& entry : manifest) {
+    mimeTypes.add(getString(entry.mimeTypeOffset, entry.mimeTypeLength));
+  }
+  inflated.resize(manifest.size());
+}
+
+std::optional<AssetStore::Asset> AssetStore::get(
+    const juce::String& path) const {
+  const auto pathHash = asset_bundle::hashPath(path);
+  const auto it = std::lower_bound(
+      manifest.begin(), manifest.end(), pathHash,
+      [](const auto& entry, auto hash) { return entry.pathHash < hash; });
+
+  // Guards against paths that aren't in the bundle but share a hash with one
+  // that is
+  if (it == manifest.end() || it->pathHash != pathHash ||
+      it->pathLength != path.getNumBytesAsUTF8() ||
+      std::memcmp(bundle + it->pathOffset, path.toRawUTF8(),
+                  it->pathLength) != 0)
+    return std::nullopt;
+
+  const auto index = static_cast<int>(it - manifest.begin());
+  const auto bytes = it->codec == asset_bundle::Codec::stored
+                         ? getStoredBytes(*it)
+                         : getInflatedBytes(static_cast<size_t>(index));
+
+  return Asset{.bytes = bytes,
+               .mimeType = mimeTypes[index],
+               .contentHash = it->contentHash};
+}
+
+juce::StringArray AssetStore::getPaths() const {
+  juce::StringArray paths;
+  for (const auto& entry : manifest) {
+    paths.add(getString(entry.pathOffset, entry.pathLength));
+  }
+  paths.sort(false);
+  return paths;
+}
+
+std::span<const std::byte> AssetStore::getStoredBytes(
+    const asset_bundle::ManifestEntry& entry) const noexcept {
+  return {bundle + entry.dataOffset, entry.storedSize};
+}
+
+juce::String AssetStore::getString(std::uint32_t offset,
+                                   std::uint32_t length) const {
+  return juce::String::fromUTF8(reinterpret_cast<const char*>(bundle + offset),
+                                static_cast<int>(length));
+}
+
+std::span<const std::byte> AssetStore::getInflatedBytes(
+    size_t entryIndex) const {
+  const std::lock_guard guard{inflatedLock};
+  auto& bytes = inflated[entryIndex];
+
+  if (bytes == nullptr) {
+    const auto& entry = manifest[entryIndex];
+    const auto stored = getStoredBytes(entry);
+    juce::GZIPDecompressorInputStream zlibStream{
+        new juce::MemoryInputStream{stored.data(), stored.size(), false},
+        true, juce::GZIPDecompressorInputStream::zlibFormat,
+        static_cast<juce::int64>(entry.size)};
+
+    std::vector<std::byte> result(entry.size);
+    [[maybe_unused]] const auto bytesRead =
+        zlibStream.read(result.data(), result.size());
+    jassert(bytesRead == static_cast<int>(result.size()));
+    jassert(asset_bundle::hash(reinterpret_cast<const char*>(result.data()),
+                               result.size()) == entry.contentHash);
+    bytes = std::make_unique<const std::vector<std::byte>>(std::move(result));
+  }
+
+  return {bytes->data(), bytes->size()};
+}
+}  // namespace webview_plugin
@@ -0,0 +1,106 @@
+#include "JuceWebViewTutorial/AudioThreadProfiler.h"
+
+namespace webview_plugin {
+const char* getStageName(ProfilerStage stage) noexcept {
+  switch (stage) {
+    case ProfilerStage::block:
+      return "block";
+    case ProfilerStage::harmonicMidi:
+      return "harmonicMidi";
+    case ProfilerStage::distortion:
+      return "distortion";
+    case ProfilerStage::additive:
+      return "additive";
+    case ProfilerStage::metering:
+      return "metering";
+    case ProfilerStage::spectrum:
+      return "spectrum";
+    case ProfilerStage::numStages:
+      break;
+  }
+
+  jassertfalse;
+  return "";
+}
+
+void ProfileStatistics::add(const ProfileRecord& record,
+                            double sampleRate) noexcept {
+  if (record.stage >= ProfilerStage::numStages || record.numSamples <= 0 ||
+      sampleRate <= 0.0)
+    return;
+
+  // Weight of the newest record in the moving average
+  constexpr auto SMOOTHING = 0.01;
+
+  auto& statistics = stages[static_cast<size_t>(record.stage)];
+  const auto seconds = juce::Time::highResolutionTicksToSeconds(record.ticks);
+  const auto budgetShare = seconds * sampleRate / record.numSamples;
+  const auto bin = juce::jlimit(
+      0, NUM_BINS,
+      static_cast<int>(budgetShare / MAX_BUDGET_SHARE * NUM_BINS));
+
+  ++statistics.histogram[static_cast<size_t>(bin)];
+  ++statistics.count;
+  statistics.totalSeconds += seconds;
+  statistics.maxSeconds = juce::jmax(statistics.maxSeconds, seconds);
+  statistics.totalBudgetShare += budgetShare;
+  statistics.recentBudgetShare +=
+      SMOOTHING * (budgetShare - statistics.recentBudgetShare);
+}
+
+void ProfileStatistics::reset() noexcept {
+  stages = {};
+}
+
+juce::var ProfileStatistics::toVar() const {
+  juce::Array<juce::var> stageArray;
+
+  for (auto i = 0u; i < stages.size(); ++i) {
+    const auto& statistics = stages[i];
+    const auto count = static_cast<double>(juce::jmax(
+        std::uint64_t{1}, statistics.count));
+
+    juce::DynamicObject::Ptr stage{new juce::DynamicObject{}};
+    stage->setProperty("name", getStageName(static_cast<ProfilerStage>(i)));
+    stage->setProperty("count", static_cast<juce::int64>(statistics.count));
+    stage->setProperty("meanUs", 1e6 * statistics.totalSeconds / count);
+    stage->setProperty("maxUs", 1e6 * statistics.maxSeconds);
+    stage->setProperty("meanBudgetShare", statistics.totalBudgetShare / count);
+    stage->setProperty("recentBudgetShare", statistics.recentBudgetShare);
+    stage->setProperty("p50BudgetShare", getPercentile(statistics, 0.5));
+    stage->setProperty("p99BudgetShare", getPercentile(statistics, 0.99));
+
+    juce::Array<juce::var> histogram;
+    for (const auto binCount : statistics.histogram) {
+      histogram.add(static_cast<int>(binCount));
+    }
+    stage->setProperty("histogram", histogram);
+
+    stageArray.add(juce::var{stage.get()});
+  }
+
+  juce::DynamicObject::Ptr result{new juce::DynamicObject{}};
+  result->setProperty("maxBudgetShare", MAX_BUDGET_SHARE);
+  result->setProperty("stages", stageArray);
+  return juce::var{result.get()};
+}
+
+double ProfileStatistics::getPercentile(const StageStatistics& statistics,
+                                        double percentile) noexcept {
+  if (statistics.count == 0)
+    return 0.0;
+
+  const auto target = percentile * static_cast<double>(statistics.count);
+  std::uint64_t cumulative = 0;
+
+  for (auto bin = 0u; bin < statistics.histogram.size(); ++bin) {
+    cumulative += statistics.histogram[bin];
+    if (static_cast<double>(cumulative) >= target) {
+      // Upper edge of the bin
+      return (bin + 1) * MAX_BUDGET_SHARE / NUM_BINS;
+    }
+  }
+
+  return MAX_BUDGET_SHARE;
+}
+}  // namespace webview_plugin
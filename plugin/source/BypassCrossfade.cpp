@@ -0,0 +1,60 @@
+#include "JuceWebViewTutorial/BypassCrossfade.h"
+
+namespace webview_plugin {
+void BypassCrossfade::prepare(double sampleRate,
+                              int numChannels,
+                              int maxBlockSize,
+                              int maxDryDelay) {
+  wetMix.reset(sampleRate, FADE_LENGTH_SECONDS);
+
+  const auto size = juce::jmax(1, maxBlockSize);
+  dryBuffer.setSize(juce::jmax(1, numChannels), size);
+  mixRamp.resize(static_cast<size_t>(size));
+
+  delayLine.setSize(juce::jmax(1, numChannels), juce::jmax(0, maxDryDelay) + 1);
+  delayLine.clear();
+  delayWritePosition = 0;
+  dryDelay = juce::jmin(dryDelay, maxDryDelay);
+}
+
+void BypassCrossfade::pushDry(
+    juce::dsp::AudioBlock<const float> input) noexcept {
+  const auto length = delayLine.getNumSamples();
+  const auto numSamples = static_cast<int>(input.getNumSamples());
+
+  for (auto channel = 0u; channel < input.getNumChannels(); ++channel) {
+    const auto* samples = input.getChannelPointer(channel);
+    auto* line = delayLine.getWritePointer(static_cast<int>(channel));
+    auto position = delayWritePosition;
+    for (auto i = 0; i < numSamples; ++i) {
+      line[position] = samples[i];
+      position = position + 1 < length ? position + 1 : 0;
+    }
+  }
+
+  delayWritePosition = (delayWritePosition + numSamples) % length;
+}
+
+void BypassCrossfade::delayDry(juce::dsp::AudioBlock<const float> input,
+                               juce::dsp::AudioBlock<float> output) noexcept {
+  const auto length = delayLine.getNumSamples();
+  const auto numSamples = static_cast<int>(input.getNumSamples());
+
+  for (auto channel = 0u; channel < input.getNumChannels(); ++channel) {
+    const auto* samples = input.getChannelPointer(channel);
+    auto* delayed = output.getChannelPointer(channel);
+    auto* line = delayLine.getWritePointer(static_cast<int>(channel));
+    auto writePosition = delayWritePosition;
+    auto readPosition = (delayWritePosition - dryDelay + length) % length;
+    for (auto i = 0; i < numSamples; ++i) {
+      // Written before reading, so that no delay passes the input through
+      line[writePosition] = samples[i];
+      delayed[i] = line[readPosition];
+      writePosition = writePosition + 1 < length ? writePosition + 1 : 0;
+      readPosition = readPosition + 1 < length ? readPosition + 1 : 0;
+    }
+  }
+
+  delayWritePosition = (delayWritePosition + numSamples) % length;
+}
+}  // namespace webview_plugin
@@ -0,0 +1,67 @@
+#include "JuceWebViewTutorial/ChebyshevPolynomial.h"
+#include <algorithm>
+
+namespace webview_plugin {
+ChebyshevPolynomial ChebyshevPolynomial::compile(const HarmonicTable& table) {
+  ChebyshevPolynomial polynomial;
+
+  // Index 0 of the table is the fundamental, i.e., T_1
+  auto sumOfMagnitudes = 0.f;
+  auto valueAtZero = 0.f;
+  for (auto h = 0; h < table.size; ++h) {
+    const auto k = h + 1;
+    // Convert 0-100 to 0-1
+    const auto coefficient = table.values[static_cast<size_t>(h)] / 100.f;
+    if (coefficient <= 0.f)
+      continue;
+
+    polynomial.coefficients[static_cast<size_t>(k)] = coefficient;
+    polynomial.degree = k;
+    sumOfMagnitudes += std::abs(coefficient);
+
+    // T_k(0) is 0 for odd k and alternates between 1 and -1 for even k
+    if (k % 2 == 0)
+      valueAtZero += k % 4 == 0 ? coefficient : -coefficient;
+  }
+
+  // |T_k(x)| <= 1 on [-1, 1], so the sum bounds the output
+  const auto scale =
+      1.f / std::max(1.f, sumOfMagnitudes + std::abs(valueAtZero));
+  for (auto& coefficient : polynomial.coefficients) {
+    coefficient *= scale;
+  }
+  polynomial.coefficients[0] = -valueAtZero * scale;
+
+  return polynomial;
+}
+
+void ChebyshevPolynomial::process(float* samples,
+                                  size_t numSamples) const noexcept {
+  for (size_t start = 0; start < numSamples; start += CHUNK_SIZE) {
+    const auto size = std::min(CHUNK_SIZE, numSamples - start);
+    auto* x = samples + start;
+
+    std::array<float, CHUNK_SIZE> twoX{};
+    std::array<float, CHUNK_SIZE> b1{};
+    std::array<float, CHUNK_SIZE> b2{};
+
+    for (size_t i = 0; i < size; ++i) {
+      x[i] = clamp(x[i]);
+      twoX[i] = 2.f * x[i];
+    }
+
+    for (auto k = degree; k > 0; --k) {
+      const auto coefficient = coefficients[static_cast<size_t>(k)];
+      for (size_t i = 0; i < size; ++i) {
+        const auto b0 = coefficient + twoX[i] * b1[i] - b2[i];
+        b2[i] = b1[i];
+        b1[i] = b0;
+      }
+    }
+
+    for (size_t i = 0; i < size; ++i) {
+      x[i] = coefficients[0] + x[i] * b1[i] - b2[i];
+    }
+  }
+}
+}  // namespace webview_plugin
@@ -0,0 +1,142 @@
+#include "JuceWebViewTutorial/HarmonicMidiGenerator.h"
+
+namespace webview_plugin {
+namespace {
+// Storage taken by a single event inside juce::MidiBuffer: the timestamp, the
+// size and the message bytes
+constexpr size_t getEventSizeInBuffer(int numMessageBytes) {
+  return sizeof(juce::int32) + sizeof(juce::uint16) +
+         static_cast<size_t>(numMessageBytes);
+}
+
+size_t getCapacity(const juce::MidiBuffer& buffer) noexcept {
+  return static_cast<size_t>(buffer.data.getNumAllocated());
+}
+}  // namespace
+
+void HarmonicMidiGenerator::prepare(int maxInputEventsPerBlock) {
+  constexpr auto NOTE_MESSAGE_SIZE = 3;
+  constexpr auto MAX_EVENTS_PER_INPUT_EVENT = 1 + HarmonicTable::MAX_HARMONICS;
+
+  reservedBytes = static_cast<size_t>(maxInputEventsPerBlock) *
+                  MAX_EVENTS_PER_INPUT_EVENT *
+                  getEventSizeInBuffer(NOTE_MESSAGE_SIZE);
+  scratch.ensureSize(reservedBytes);
+  scratch.clear();
+  spare.ensureSize(reservedBytes);
+  spare.clear();
+
+  activeNotes.prepare();
+  capacityOverflows = 0;
+}
+
+void HarmonicMidiGenerator::reset() noexcept {
+  activeNotes.reset();
+}
+
+void HarmonicMidiGenerator::process(juce::MidiBuffer& midiMessages,
+                                    const VoicingPlan& plan) {
+  clearScratch();
+
+  // MidiBuffer iterates in time order
+  for (const auto metadata : midiMessages) {
+    const auto message = metadata.getMessage();
+    const auto time = metadata.samplePosition;
+    const auto channel = message.getChannel();
+
+    const auto emitHarmonicNoteOff = [&](int harmonicNote) {
+      addEvent(juce::MidiMessage::noteOff(channel, harmonicNote), time);
+    };
+
+    if (message.isNoteOn()) {
+      const int rootNote = message.getNoteNumber();
+
+      // Add the original MIDI message to our output buffer
+      addEvent(message, time);
+      activeNotes.startNote(channel, rootNote, emitHarmonicNoteOff);
+
+      const int velocity = message.getVelocity();
+
+      // Voices are sorted by pitch: stop at the first one out of MIDI range
+      for (int v = 0; v < plan.size; ++v) {
+        const auto& voice = plan.voices[static_cast<size_t>(v)];
+        const int harmonicNote = rootNote + voice.semitoneOffset;
+
+        if (harmonicNote > 127)
+          break;
+
+        // Set velocity based on the harmonic value (scaled by the original
+        // note velocity)
+        const int harmonicVelocity = juce::jlimit(
+            1, 127, static_cast<int>(velocity * voice.velocityScale));
+
+        addEvent(juce::MidiMessage::noteOn(
+                     channel, harmonicNote,
+                     static_cast<juce::uint8>(harmonicVelocity)),
+                 time);
+
+        activeNotes.addHarmonic(channel, rootNote, harmonicNote);
+      }
+    } else if (message.isNoteOff()) {
+      const int rootNote = message.getNoteNumber();
+
+      // A note that is still referenced by another held note keeps sounding
+      if (activeNotes.releaseRoot(channel, rootNote))
+        addEvent(message, time);
+
+      // Generate note offs for all harmonics of this note
+      activeNotes.releaseHarmonics(channel, rootNote, emitHarmonicNoteOff);
+    } else {
+      if (message.isAllNotesOff())
+        activeNotes.resetChannel(channel);
+
+      addEvent(message, time);
+    }
+  }
+
+  swapScratchWith(midiMessages);
+}
+
+void HarmonicMidiGenerator::releaseAll(juce::MidiBuffer& midiMessages) {
+  clearScratch();
+
+  // Added first, so they precede any note-on at the same sample
+  activeNotes.releaseAll([this](int channel, int harmonicNote) {
+    addEvent(juce::MidiMessage::noteOff(channel, harmonicNote), 0);
+  });
+
+  for (const auto metadata : midiMessages) {
+    addEvent(metadata.getMessage(), metadata.samplePosition);
+  }
+
+  swapScratchWith(midiMessages);
+}
+
+void HarmonicMidiGenerator::clearScratch() noexcept {
+  // clear() keeps the allocated storage
+  scratch.clear();
+  scratchCapacity = getCapacity(scratch);
+  usedBytes = 0;
+}
+
+void HarmonicMidiGenerator::swapScratchWith(
+    juce::MidiBuffer& midiMessages) noexcept {
+  if (usedBytes > scratchCapacity)
+    capacityOverflows.fetch_add(1, std::memory_order_relaxed);
+
+  midiMessages.swapWith(scratch);
+
+  // Storage too small for the next block is parked in place of the spare,
+  // as long as the spare is of full size
+  if (getCapacity(scratch) < reservedBytes &&
+      getCapacity(spare) >= reservedBytes) {
+    scratch.swapWith(spare);
+  }
+}
+
+void HarmonicMidiGenerator::addEvent(const juce::MidiMessage& message,
+                                     int samplePosition) {
+  usedBytes += getEventSizeInBuffer(message.getRawDataSize());
+  scratch.addEvent(message, samplePosition);
+}
+}  // namespace webview_plugin
@@ -0,0 +1,43 @@
+#include "JuceWebViewTutorial/HarmonicVoicing.h"
+#include <cmath>
+
+namespace webview_plugin {
+namespace {
+/**
+ * @brief Distance in semitones between the fundamental and each harmonic,
+ * rounded to the nearest semitone (harmonic n lies 12 * log2(n) semitones
+ * above the fundamental).
+ */
+const std::array<int, HarmonicTable::MAX_HARMONICS>& getSemitoneOffsets() {
+  static const auto offsets = [] {
+    std::array<int, HarmonicTable::MAX_HARMONICS> result{};
+    for (auto h = 0u; h < result.size(); ++h) {
+      result[h] = static_cast<int>(
+          std::lround(12.0 * std::log2(static_cast<double>(h + 1))));
+    }
+    return result;
+  }();
+  return offsets;
+}
+}  // namespace
+
+VoicingPlan VoicingPlan::compile(const HarmonicTable& table) {
+  const auto& semitoneOffsets = getSemitoneOffsets();
+  VoicingPlan plan;
+
+  // Skip the fundamental: it is the incoming note itself
+  for (auto h = 1; h < table.size; ++h) {
+    const auto index = static_cast<size_t>(h);
+    // Convert 0-100 to 0-1
+    const auto normalizedValue = table.values[index] / 100.f;
+
+    if (normalizedValue > AUDIBILITY_THRESHOLD) {
+      plan.voices[static_cast<size_t>(plan.size++)] = {
+          .semitoneOffset = semitoneOffsets[index],
+          .velocityScale = normalizedValue};
+    }
+  }
+
+  return plan;
+}
+}  // namespace webview_plugin
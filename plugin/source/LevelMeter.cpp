@@ -0,0 +1,163 @@
+#include "JuceWebViewTutorial/LevelMeter.h"
+#include <cmath>
+#include <numeric>
+
+namespace webview_plugin {
+namespace {
+// Independent partial sums let compilers keep all lanes in one SIMD register
+// without reassociating the floating-point additions themselves
+constexpr size_t REDUCTION_LANES = 8;
+
+float getSquareSum(const float* samples, size_t numSamples) noexcept {
+  std::array<float, REDUCTION_LANES> sums{};
+  size_t i = 0;
+
+  for (; i + REDUCTION_LANES <= numSamples; i += REDUCTION_LANES) {
+    for (size_t lane = 0; lane < REDUCTION_LANES; ++lane) {
+      sums[lane] += samples[i + lane] * samples[i + lane];
+    }
+  }
+
+  auto sum = std::accumulate(sums.begin(), sums.end(), 0.f);
+  for (; i < numSamples; ++i) {
+    sum += samples[i] * samples[i];
+  }
+  return sum;
+}
+
+float getPeak(const float* samples, size_t numSamples) noexcept {
+  const auto range = juce::FloatVectorOperations::findMinAndMax(
+      samples, static_cast<int>(numSamples));
+  return juce::jmax(-range.getStart(), range.getEnd());
+}
+
+// Coefficient of a one-pole ballistics filter after numSamples samples,
+// defined like juce::dsp::BallisticsFilter's
+float getBallisticsCoefficient(double seconds, double timeConstant) noexcept {
+  return static_cast<float>(
+      std::exp(-juce::MathConstants<double>::twoPi * seconds / timeConstant));
+}
+}  // namespace
+
+void LevelMeter::prepare(double newSampleRate,
+                         const juce::AudioChannelSet& channelLayout,
+                         int maxBlockSize) {
+  sampleRate = newSampleRate;
+  numChannels =
+      juce::jlimit(0, MeterSnapshot::MAX_CHANNELS, channelLayout.size());
+  truePeakDetector.prepare(numChannels, maxBlockSize);
+  loudnessMeter.prepare(sampleRate, channelLayout);
+
+  activeMeters = 0;
+  peakEnvelopes.fill(0.f);
+  resetAccumulators();
+  consumed.store(false, std::memory_order_relaxed);
+}
+
+void LevelMeter::process(
+    const juce::dsp::AudioBlock<const float>& signal) noexcept {
+  const auto numSamples = signal.getNumSamples();
+  if (numSamples == 0)
+    return;
+
+  const auto meters = getEnabledMeters();
+  if (meters != activeMeters) {
+    // Don't let levels from before a meter was switched off show up
+    const auto switchedOn = static_cast<std::uint8_t>(meters & ~activeMeters);
+    if (switchedOn & peak)
+      peakEnvelopes.fill(0.f);
+    if (switchedOn & truePeak)
+      truePeakDetector.reset();
+    if (switchedOn & loudness)
+      loudnessMeter.reset();
+
+    activeMeters = meters;
+    resetAccumulators();
+  }
+
+  if (consumed.exchange(false, std::memory_order_acquire)) {
+    resetAccumulators();
+  }
+
+  const auto channelsToMeter =
+      juce::jmin(static_cast<size_t>(numChannels), signal.getNumChannels());
+
+  for (size_t channel = 0; channel < channelsToMeter; ++channel) {
+    const auto* samples = signal.getChannelPointer(channel);
+
+    if (meters & peak)
+      blockPeaks[channel] = getPeak(samples, numSamples);
+
+    if (meters & rms)
+      squareSumAccumulator[channel] += getSquareSum(samples, numSamples);
+
+    if (meters & truePeak) {
+      truePeakAccumulator[channel] = juce::jmax(
+          truePeakAccumulator[channel],
+          truePeakDetector.process(static_cast<int>(channel), samples,
+                                   numSamples));
+    }
+  }
+
+  if (meters & peak)
+    applyPeakBallistics(channelsToMeter, numSamples);
+
+  if (meters & loudness)
+    loudnessMeter.process(signal);
+
+  numAccumulatedSamples += static_cast<juce::int64>(numSamples);
+
+  auto& snapshot = snapshots.getWriteBuffer();
+  snapshot.numChannels = static_cast<int>(channelsToMeter);
+  snapshot.enabledMeters = meters;
+  for (size_t channel = 0; channel < channelsToMeter; ++channel) {
+    snapshot.peak[channel] = peakAccumulator[channel];
+    snapshot.rms[channel] = static_cast<float>(std::sqrt(
+        squareSumAccumulator[channel] /
+        static_cast<double>(numAccumulatedSamples)));
+    snapshot.truePeak[channel] = truePeakAccumulator[channel];
+  }
+
+  const auto isLoudnessMetered = (meters & loudness) != 0;
+  snapshot.momentaryLoudness = isLoudnessMetered
+                                   ? loudnessMeter.getMomentaryLoudness()
+                                   : LoudnessMeter::MIN_LOUDNESS;
+  snapshot.shortTermLoudness = isLoudnessMetered
+                                   ? loudnessMeter.getShortTermLoudness()
+                                   : LoudnessMeter::MIN_LOUDNESS;
+  snapshots.publish();
+}
+
+std::optional<MeterSnapshot> LevelMeter::pull() noexcept {
+  if (!snapshots.hasNewData())
+    return std::nullopt;
+
+  const auto snapshot = snapshots.read();
+  consumed.store(true, std::memory_order_release);
+  return snapshot;
+}
+
+void LevelMeter::applyPeakBallistics(size_t numChannelsToMeter,
+                                     size_t numSamples) noexcept {
+  // The block's peak is treated as if it had lasted the whole block, so the
+  // per-sample recursion collapses into a single step
+  const auto seconds = static_cast<double>(numSamples) / sampleRate;
+  const auto attack = getBallisticsCoefficient(seconds, PEAK_ATTACK_SECONDS);
+  const auto release = getBallisticsCoefficient(seconds, PEAK_RELEASE_SECONDS);
+
+  for (size_t channel = 0; channel < numChannelsToMeter; ++channel) {
+    const auto blockPeak = blockPeaks[channel];
+    auto& envelope = peakEnvelopes[channel];
+    const auto coefficient = blockPeak > envelope ? attack : release;
+    envelope = blockPeak + coefficient * (envelope - blockPeak);
+    peakAccumulator[channel] = juce::jmax(peakAccumulator[channel], envelope);
+  }
+}
+
+void LevelMeter::resetAccumulators() noexcept {
+  peakAccumulator.fill(0.f);
+  squareSumAccumulator.fill(0.0);
+  truePeakAccumulator.fill(0.f);
+  numAccumulatedSamples = 0;
+}
+}  // namespace webview_plugin
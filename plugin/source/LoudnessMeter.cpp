@@ -0,0 +1,166 @@
+#include "JuceWebViewTutorial/LoudnessMeter.h"
+#include <algorithm>
+#include <cmath>
+
+namespace webview_plugin {
+namespace {
+// K-weighting stages of ITU-R BS.1770, parametrized so that they can be
+// designed for any sample rate; at 48 kHz they match the coefficients given
+// in the recommendation
+constexpr auto SHELF_FREQUENCY = 1681.974450955533;
+constexpr auto SHELF_GAIN_DB = 3.999843853973347;
+constexpr auto SHELF_Q = 0.7071752369554196;
+constexpr auto HIGH_PASS_FREQUENCY = 38.13547087602444;
+constexpr auto HIGH_PASS_Q = 0.5003270373238773;
+}  // namespace
+
+void LoudnessMeter::prepare(double sampleRate,
+                            const juce::AudioChannelSet& channelLayout) {
+  using juce::MathConstants;
+
+  Biquad shelf;
+  {
+    const auto a = std::pow(10.0, SHELF_GAIN_DB / 40.0);
+    const auto w0 = MathConstants<double>::twoPi * SHELF_FREQUENCY / sampleRate;
+    const auto cosW0 = std::cos(w0);
+    const auto alpha = std::sin(w0) / (2.0 * SHELF_Q);
+    const auto sqrtAAlpha = 2.0 * std::sqrt(a) * alpha;
+    const auto a0 = (a + 1.0) - (a - 1.0) * cosW0 + sqrtAAlpha;
+
+    shelf.b0 = a * ((a + 1.0) + (a - 1.0) * cosW0 + sqrtAAlpha) / a0;
+    shelf.b1 = -2.0 * a * ((a - 1.0) + (a + 1.0) * cosW0) / a0;
+    shelf.b2 = a * ((a + 1.0) + (a - 1.0) * cosW0 - sqrtAAlpha) / a0;
+    shelf.a1 = 2.0 * ((a - 1.0) - (a + 1.0) * cosW0) / a0;
+    shelf.a2 = ((a + 1.0) - (a - 1.0) * cosW0 - sqrtAAlpha) / a0;
+  }
+
+  Biquad highPass;
+  {
+    const auto w0 =
+        MathConstants<double>::twoPi * HIGH_PASS_FREQUENCY / sampleRate;
+    const auto cosW0 = std::cos(w0);
+    const auto alpha = std::sin(w0) / (2.0 * HIGH_PASS_Q);
+    const auto a0 = 1.0 + alpha;
+
+    highPass.b0 = 0.5 * (1.0 + cosW0) / a0;
+    highPass.b1 = -(1.0 + cosW0) / a0;
+    highPass.b2 = highPass.b0;
+    highPass.a1 = -2.0 * cosW0 / a0;
+    highPass.a2 = (1.0 - alpha) / a0;
+  }
+
+  const auto numChannels = static_cast<size_t>(channelLayout.size());
+  channels.assign(numChannels, Channel{.shelf = shelf, .highPass = highPass});
+  for (size_t channel = 0; channel < numChannels; ++channel) {
+    // Discrete layouts have no surround channels
+    channels[channel].weight =
+        channelLayout.isDiscreteLayout()
+            ? 1.f
+            : getChannelWeight(channelLayout.getTypeOfChannel(
+                  static_cast<int>(channel)));
+  }
+
+  segmentSquareSums.assign(numChannels, 0.0);
+  samplesPerSegment =
+      juce::jmax(1, juce::roundToInt(SEGMENT_SECONDS * sampleRate));
+  reset();
+}
+
+void LoudnessMeter::reset() noexcept {
+  for (auto& channel : channels) {
+    channel.shelf.z1 = channel.shelf.z2 = 0.0;
+    channel.highPass.z1 = channel.highPass.z2 = 0.0;
+  }
+  std::fill(segmentSquareSums.begin(), segmentSquareSums.end(), 0.0);
+  segments.fill(0.0);
+  nextSegment = 0;
+  samplesInSegment = 0;
+  momentaryLoudness = MIN_LOUDNESS;
+  shortTermLoudness = MIN_LOUDNESS;
+}
+
+void LoudnessMeter::process(
+    const juce::dsp::AudioBlock<const float>& block) noexcept {
+  const auto numChannels = std::min(channels.size(), block.getNumChannels());
+  const auto numSamples = static_cast<int>(block.getNumSamples());
+
+  // Processed in pieces that end at segment boundaries
+  for (auto start = 0; start < numSamples;) {
+    const auto length =
+        std::min(numSamples - start, samplesPerSegment - samplesInSegment);
+
+    for (size_t channel = 0; channel < numChannels; ++channel) {
+      auto& [shelf, highPass, weight] = channels[channel];
+      if (weight == 0.f)
+        continue;
+
+      const auto* samples = block.getChannelPointer(channel) + start;
+      auto squareSum = 0.0;
+      for (auto i = 0; i < length; ++i) {
+        const auto weighted =
+            highPass.processSample(shelf.processSample(samples[i]));
+        squareSum += weighted * weighted;
+      }
+      segmentSquareSums[channel] += squareSum;
+    }
+
+    start += length;
+    samplesInSegment += length;
+    if (samplesInSegment == samplesPerSegment)
+      finishSegment();
+  }
+}
+
+float LoudnessMeter::getChannelWeight(
+    juce::AudioChannelSet::ChannelType type) noexcept {
+  using ChannelType = juce::AudioChannelSet::ChannelType;
+
+  switch (type) {
+    case ChannelType::LFE:
+    case ChannelType::LFE2:
+      return 0.f;
+    case ChannelType::leftSurround:
+    case ChannelType::rightSurround:
+    case ChannelType::centreSurround:
+    case ChannelType::leftSurroundSide:
+    case ChannelType::rightSurroundSide:
+    case ChannelType::leftSurroundRear:
+    case ChannelType::rightSurroundRear:
+      return 1.41f;
+    default:
+      return 1.f;
+  }
+}
+
+void LoudnessMeter::finishSegment() noexcept {
+  auto weightedSum = 0.0;
+  for (size_t channel = 0; channel < channels.size(); ++channel) {
+    weightedSum += channels[channel].weight * segmentSquareSums[channel];
+  }
+  std::fill(segmentSquareSums.begin(), segmentSquareSums.end(), 0.0);
+
+  segments[static_cast<size_t>(nextSegment)] = weightedSum;
+  nextSegment = (nextSegment + 1) % SHORT_TERM_SEGMENTS;
+  samplesInSegment = 0;
+
+  momentaryLoudness = getLoudness(MOMENTARY_SEGMENTS);
+  shortTermLoudness = getLoudness(SHORT_TERM_SEGMENTS);
+}
+
+float LoudnessMeter::getLoudness(int numSegments) const noexcept {
+  // The most recent numSegments segments, going back from nextSegment
+  auto sum = 0.0;
+  for (auto i = 1; i <= numSegments; ++i) {
+    sum += segments[static_cast<size_t>(
+        (nextSegment - i + SHORT_TERM_SEGMENTS) % SHORT_TERM_SEGMENTS)];
+  }
+
+  const auto meanSquare =
+      sum / (static_cast<double>(numSegments) * samplesPerSegment);
+  if (meanSquare <= 0.0)
+    return MIN_LOUDNESS;
+
+  return juce::jmax(MIN_LOUDNESS,
+                    static_cast<float>(-0.691 + 10.0 * std::log10(meanSquare)));
+}
+}  // namespace webview_plugin
@@ -0,0 +1,117 @@
+#include "JuceWebViewTutorial/OutputStage.h"
+#include <algorithm>
+#include <cmath>
+#include <tuple>
+
+namespace webview_plugin {
+namespace {
+using PanSide = OutputStage::PanSide;
+
+PanSide getPanSideOfType(juce::AudioChannelSet::ChannelType type) noexcept {
+  using ChannelType = juce::AudioChannelSet::ChannelType;
+
+  switch (type) {
+    case ChannelType::left:
+    case ChannelType::leftCentre:
+    case ChannelType::leftSurround:
+    case ChannelType::leftSurroundSide:
+    case ChannelType::leftSurroundRear:
+    case ChannelType::wideLeft:
+    case ChannelType::topFrontLeft:
+    case ChannelType::topSideLeft:
+    case ChannelType::topRearLeft:
+    case ChannelType::bottomFrontLeft:
+    case ChannelType::bottomSideLeft:
+    case ChannelType::bottomRearLeft:
+    case ChannelType::proximityLeft:
+      return PanSide::left;
+    case ChannelType::right:
+    case ChannelType::rightCentre:
+    case ChannelType::rightSurround:
+    case ChannelType::rightSurroundSide:
+    case ChannelType::rightSurroundRear:
+    case ChannelType::wideRight:
+    case ChannelType::topFrontRight:
+    case ChannelType::topSideRight:
+    case ChannelType::topRearRight:
+    case ChannelType::bottomFrontRight:
+    case ChannelType::bottomSideRight:
+    case ChannelType::bottomRearRight:
+    case ChannelType::proximityRight:
+      return PanSide::right;
+    default:
+      return PanSide::centre;
+  }
+}
+}  // namespace
+
+void OutputStage::prepare(double sampleRate,
+                          int maxBlockSize,
+                          const juce::AudioChannelSet& channelLayout) {
+  gainSmoother.reset(sampleRate, RAMP_LENGTH_SECONDS);
+  panSmoother.reset(sampleRate, RAMP_LENGTH_SECONDS);
+  panSides = getPanSides(channelLayout);
+
+  const auto rampSize = static_cast<size_t>(juce::jmax(1, maxBlockSize));
+  gainRamp.resize(rampSize);
+  leftGainRamp.resize(rampSize);
+  rightGainRamp.resize(rampSize);
+  unityRamp.assign(rampSize, 1.f);
+}
+
+void OutputStage::reset(float gain, float pan) noexcept {
+  gainSmoother.setCurrentAndTargetValue(gain);
+  panSmoother.setCurrentAndTargetValue(pan);
+}
+
+auto OutputStage::getPanSides(const juce::AudioChannelSet& channelLayout)
+    -> std::vector<PanSide> {
+  const auto numChannels = static_cast<size_t>(channelLayout.size());
+  std::vector<PanSide> sides(numChannels, PanSide::centre);
+
+  if (channelLayout.isDiscreteLayout()) {
+    for (size_t channel = 0; channel + 1 < numChannels; channel += 2) {
+      sides[channel] = PanSide::left;
+      sides[channel + 1] = PanSide::right;
+    }
+    return sides;
+  }
+
+  for (size_t channel = 0; channel < numChannels; ++channel) {
+    sides[channel] = getPanSideOfType(
+        channelLayout.getTypeOfChannel(static_cast<int>(channel)));
+  }
+  return sides;
+}
+
+std::pair<float, float> OutputStage::getPanGains(float pan) noexcept {
+  // Convert pan parameter from 0-1 range to -1 to 1 range
+  const float panValue = 2.0f * pan - 1.0f;
+
+  const float leftGain =
+      std::cos((panValue + 1.0f) * juce::MathConstants<float>::pi * 0.25f);
+  const float rightGain =
+      std::sin((panValue + 1.0f) * juce::MathConstants<float>::pi * 0.25f);
+  return {leftGain, rightGain};
+}
+
+void OutputStage::fillRamps(size_t numSamples) noexcept {
+  jassert(numSamples <= gainRamp.size());
+
+  for (auto i = 0u; i < numSamples; ++i) {
+    gainRamp[i] = gainSmoother.getNextValue();
+  }
+
+  if (panSmoother.isSmoothing()) {
+    for (auto i = 0u; i < numSamples; ++i) {
+      std::tie(leftGainRamp[i], rightGainRamp[i]) =
+          getPanGains(panSmoother.getNextValue());
+    }
+  } else {
+    const auto [leftGain, rightGain] =
+        getPanGains(panSmoother.getTargetValue());
+    std::fill_n(leftGainRamp.begin(), numSamples, leftGain);
+    std::fill_n(rightGainRamp.begin(), numSamples, rightGain);
+  }
+}
+}  // namespace webview_plugin
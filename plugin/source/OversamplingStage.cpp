@@ -0,0 +1,53 @@
+#include "JuceWebViewTutorial/OversamplingStage.h"
+
+namespace webview_plugin {
+void OversamplingStage::prepare(int numChannels, int maxBlockSize) {
+  using juce::dsp::Oversampling;
+
+  constexpr std::array filterTypes{
+      Oversampling<float>::filterHalfBandPolyphaseIIR,
+      Oversampling<float>::filterHalfBandFIREquiripple};
+
+  for (auto filter = 0u; filter < oversamplers.size(); ++filter) {
+    for (auto i = 0u; i < oversamplers[filter].size(); ++i) {
+      // The factor is passed as a power of two
+      auto oversampler = std::make_unique<Oversampler>(
+          static_cast<size_t>(numChannels), i + 1, filterTypes[filter], true,
+          true);
+      oversampler->initProcessing(static_cast<size_t>(maxBlockSize));
+      oversamplers[filter][i] = std::move(oversampler);
+    }
+  }
+
+  activeOversampler = nullptr;
+}
+
+void OversamplingStage::reset() noexcept {
+  for (auto& oversamplersOfType : oversamplers) {
+    for (auto& oversampler : oversamplersOfType) {
+      if (oversampler != nullptr)
+        oversampler->reset();
+    }
+  }
+}
+
+int OversamplingStage::getLatencyInSamples(
+    int factorIndex,
+    FilterType filterType) const noexcept {
+  if (const auto* oversampler = getOversampler(factorIndex, filterType))
+    return juce::roundToInt(oversampler->getLatencyInSamples());
+
+  return 0;
+}
+
+auto OversamplingStage::getOversampler(int factorIndex,
+                                       FilterType filterType) const noexcept
+    -> Oversampler* {
+  if (factorIndex <= 0 || factorIndex >= NUM_FACTORS)
+    return nullptr;
+
+  return oversamplers[static_cast<size_t>(filterType)]
+                     [static_cast<size_t>(factorIndex - 1)]
+                         .get();
+}
+}  // namespace webview_plugin
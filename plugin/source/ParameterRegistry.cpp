@@ -0,0 +1,105 @@
+#include "JuceWebViewTutorial/ParameterRegistry.h"
+#include "JuceWebViewTutorial/ParameterIDs.hpp"
+
+namespace webview_plugin {
+namespace {
+std::vector<ParameterSpec> createParameterSpecs() {
+  using Type = ParameterSpec::Type;
+
+  std::vector<ParameterSpec> specs{
+      {.id = id::GAIN,
+       .name = "gain",
+       .range = {0.f, 1.f, 0.01f, 0.9f},
+       .defaultValue = 1.f,
+       .hasWebRelay = true},
+      {.id = id::BYPASS,
+       .name = "bypass",
+       .type = Type::toggle,
+       .label = "Bypass",
+       .hasWebRelay = true},
+      {.id = id::DISTORTION_TYPE,
+       .name = "distortion type",
+       .type = Type::choice,
+       .choices = {"none", "tanh(kx)/tanh(k)", "sigmoid"},
+       .hasWebRelay = true},
+      {.id = id::PAN,
+       .name = "pan",
+       .range = {0.f, 1.f, 0.01f, 0.5f},
+       .defaultValue = 0.5f,
+       .hasWebRelay = true},
+      {.id = id::OVERSAMPLING,
+       .name = "oversampling",
+       .type = Type::choice,
+       .choices = {"1x", "2x", "4x", "8x"}},
+      {.id = id::OVERSAMPLING_FILTER,
+       .name = "oversampling filter",
+       .type = Type::choice,
+       .choices = {"polyphase IIR", "FIR equiripple"}},
+      {.id = id::HARMONIC_ENGINE,
+       .name = "harmonic engine",
+       .type = Type::choice,
+       .choices = {"MIDI output", "internal additive"}},
+      // Not a DISTORTION_TYPE choice: another choice would change what the
+      // normalized values of the existing ones select in saved automation
+      {.id = id::HARMONIC_EXCITER,
+       .name = "harmonic exciter",
+       .type = Type::toggle,
+       .label = "Harmonic Exciter",
+       .hasWebRelay = true},
+  };
+
+  // The web UI edits the harmonics as a whole, see "harmonicsChanged"
+  for (auto i = 0; i < HarmonicTable::MAX_HARMONICS; ++i) {
+    specs.push_back({.id = id::harmonic(i),
+                     .name = "harmonic " + juce::String{i + 1},
+                     .range = {0.f, 100.f},
+                     .harmonicIndex = i});
+  }
+
+  return specs;
+}
+}  // namespace
+
+const std::vector<ParameterSpec>& getParameterSpecs() {
+  static const auto specs = createParameterSpecs();
+  return specs;
+}
+
+HarmonicParameter::HarmonicParameter(
+    const ParameterSpec& spec,
+    std::atomic<std::uint64_t>& changedHarmonicsToUse)
+    : AudioParameterFloat{spec.id, spec.name, spec.range, spec.defaultValue},
+      harmonicIndex{spec.harmonicIndex},
+      changedHarmonics{changedHarmonicsToUse} {
+  jassert(juce::isPositiveAndBelow(harmonicIndex, HarmonicTable::MAX_HARMONICS));
+}
+
+void HarmonicParameter::valueChanged(float) {
+  // Released after the new value is stored, see AudioParameterFloat::setValue()
+  changedHarmonics.fetch_or(std::uint64_t{1} << harmonicIndex,
+                            std::memory_order_release);
+}
+
+std::unique_ptr<juce::RangedAudioParameter> createParameter(
+    const ParameterSpec& spec,
+    std::atomic<std::uint64_t>& changedHarmonics) {
+  if (spec.harmonicIndex >= 0)
+    return std::make_unique<HarmonicParameter>(spec, changedHarmonics);
+
+  switch (spec.type) {
+    case ParameterSpec::Type::toggle:
+      return std::make_unique<juce::AudioParameterBool>(
+          spec.id, spec.name, spec.defaultValue >= 0.5f,
+          juce::AudioParameterBoolAttributes{}.withLabel(spec.label));
+    case ParameterSpec::Type::choice:
+      return std::make_unique<juce::AudioParameterChoice>(
+          spec.id, spec.name, spec.choices,
+          juce::roundToInt(spec.defaultValue));
+    case ParameterSpec::Type::continuous:
+      break;
+  }
+
+  return std::make_unique<juce::AudioParameterFloat>(
+      spec.id, spec.name, spec.range, spec.defaultValue);
+}
+}  // namespace webview_plugin
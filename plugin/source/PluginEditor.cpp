@@ -1,19 +1,27 @@
 #include "JuceWebViewTutorial/PluginEditor.h"
 #include <juce_audio_processors/juce_audio_processors.h>
 #include <juce_events/juce_events.h>
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <limits>
 #include <optional>
 #include <ranges>
+#include <span>
 #include "JuceWebViewTutorial/PluginProcessor.h"
+#include "JuceWebViewTutorial/SharedResources.h"
 #include "juce_core/juce_core.h"
 #include "juce_graphics/juce_graphics.h"
 #include "juce_gui_extra/juce_gui_extra.h"
 #include "JuceWebViewTutorial/ParameterIDs.hpp"
-#include <WebViewFiles.h>
 
 namespace webview_plugin {
 
-// Development mode toggle - set to true to use the dev server with hot reloading
-constexpr bool USE_DEV_SERVER = true;
+// Set by the WEBVIEW_PLUGIN_USE_DEV_SERVER CMake option
+#ifndef WEBVIEW_PLUGIN_USE_DEV_SERVER
+#define WEBVIEW_PLUGIN_USE_DEV_SERVER 0
+#endif
 
 namespace {
 std::vector<std::byte> streamToVector(juce::InputStream& stream) {
@@ -27,72 +35,157 @@ std::vector<std::byte> streamToVector(juce::InputStream& stream) {
   return result;
 }
 
-static const char* getMimeForExtension(const juce::String& extension) {
-  static const std::unordered_map<juce::String, const char*> mimeMap = {
-      {{"htm"}, "text/html"},
-      {{"html"}, "text/html"},
-      {{"txt"}, "text/plain"},
-      {{"jpg"}, "image/jpeg"},
-      {{"jpeg"}, "image/jpeg"},
-      {{"svg"}, "image/svg+xml"},
-      {{"ico"}, "image/vnd.microsoft.icon"},
-      {{"json"}, "application/json"},
-      {{"png"}, "image/png"},
-      {{"css"}, "text/css"},
-      {{"map"}, "application/json"},
-      {{"js"}, "text/javascript"},
-      {{"woff2"}, "font/woff2"}};
-
-  if (const auto it = mimeMap.find(extension.toLowerCase());
-      it != mimeMap.end())
-    return it->second;
-
-  jassertfalse;
-  return "";
-}
-
 juce::Identifier getExampleEventId() {
   static const juce::Identifier id{"exampleEvent"};
   return id;
 }
 
-#ifndef ZIPPED_FILES_PREFIX
-#error \
-    "You must provide the prefix of zipped web UI files' paths, e.g., 'public/', in the ZIPPED_FILES_PREFIX compile definition"
-#endif
+constexpr auto LOCAL_DEV_SERVER_ADDRESS = "http://127.0.0.1:8080";
 
 /**
- * @brief Get a web UI file as bytes
+ * @brief Whether to load the web UI from the React dev server (hot reloading)
  *
- * @param filepath path of the form "index.html", "js/index.js", etc.
- * @return std::vector<std::byte> with bytes of a read file or an empty vector
- * if the file is not contained in webview_files.zip
+ * Enabled at build time or, for any build, by setting the environment variable
+ * WEBVIEW_PLUGIN_DEV_SERVER=1.
  */
-std::vector<std::byte> getWebViewFileAsBytes(const juce::String& filepath) {
-  juce::MemoryInputStream zipStream{webview_files::webview_files_zip,
-                                    webview_files::webview_files_zipSize,
-                                    false};
-  juce::ZipFile zipFile{zipStream};
-
-  if (auto* zipEntry = zipFile.getEntry(ZIPPED_FILES_PREFIX + filepath)) {
-    const std::unique_ptr<juce::InputStream> entryStream{
-        zipFile.createStreamForEntry(*zipEntry)};
-
-    if (entryStream == nullptr) {
-      jassertfalse;
-      return {};
+bool shouldUseDevServer() {
+  return WEBVIEW_PLUGIN_USE_DEV_SERVER != 0 ||
+         juce::SystemStats::getEnvironmentVariable("WEBVIEW_PLUGIN_DEV_SERVER",
+                                                   {})
+                 .getIntValue() != 0;
+}
+
+// The timer also drains the profiler ring, which holds a few thousand
+// records: MIN_METER_FRAME_RATE_HZ is high enough for small blocks at high
+// sample rates not to overflow it
+constexpr auto DEFAULT_METER_FRAME_RATE_HZ = 30;
+constexpr auto MIN_METER_FRAME_RATE_HZ = 10;
+constexpr auto MAX_METER_FRAME_RATE_HZ = 120;
+
+juce::Identifier getMeterFrameEventId() {
+  static const juce::Identifier id{"meterFrame"};
+  return id;
+}
+
+juce::Identifier getSpectrumFrameEventId() {
+  static const juce::Identifier id{"spectrumFrame"};
+  return id;
+}
+
+juce::Identifier getHarmonicsChangedEventId() {
+  static const juce::Identifier id{"harmonicsChanged"};
+  return id;
+}
+
+juce::Identifier getProgramChangedEventId() {
+  static const juce::Identifier id{"programChanged"};
+  return id;
+}
+
+/**
+ * @brief Decodes standard base64 without allocating
+ *
+ * @return the number of bytes written to destination or std::nullopt if text
+ * is malformed or doesn't fit into destination
+ */
+std::optional<size_t> decodeBase64(const juce::String& text,
+                                   std::span<std::byte> destination) {
+  const auto* characters = text.toRawUTF8();
+  const auto length = text.getNumBytesAsUTF8();
+
+  if (length % 4 != 0)
+    return std::nullopt;
+
+  const auto decodeCharacter = [](char character) {
+    if (character >= 'A' && character <= 'Z')
+      return character - 'A';
+    if (character >= 'a' && character <= 'z')
+      return character - 'a' + 26;
+    if (character >= '0' && character <= '9')
+      return character - '0' + 52;
+    if (character == '+')
+      return 62;
+    if (character == '/')
+      return 63;
+    return -1;
+  };
+
+  size_t numBytes = 0;
+  for (size_t i = 0; i < length; i += 4) {
+    std::uint32_t bits = 0;
+    size_t numPaddingCharacters = 0;
+
+    for (size_t j = 0; j < 4; ++j) {
+      const auto character = characters[i + j];
+
+      // Up to two padding characters, at the very end only
+      if (character == '=' && i + 4 == length && j >= 2) {
+        ++numPaddingCharacters;
+        bits <<= 6;
+        continue;
+      }
+
+      const auto value = decodeCharacter(character);
+      if (value < 0 || numPaddingCharacters > 0)
+        return std::nullopt;
+      bits = (bits << 6) | static_cast<std::uint32_t>(value);
     }
 
-    return streamToVector(*entryStream);
+    const auto numDecodedBytes = 3 - numPaddingCharacters;
+    if (numBytes + numDecodedBytes > destination.size())
+      return std::nullopt;
+
+    for (size_t k = 0; k < numDecodedBytes; ++k) {
+      destination[numBytes++] =
+          static_cast<std::byte>((bits >> (16 - 8 * k)) & 0xff);
+    }
   }
 
-  return {};
+  return numBytes;
 }
 
-constexpr auto LOCAL_DEV_SERVER_ADDRESS = "http://127.0.0.1:8080";
+juce::WebBrowserComponent::Resource makeJsonResource(const juce::var& data) {
+  const auto jsonString = juce::JSON::toString(data);
+  juce::MemoryInputStream stream{jsonString.getCharPointer(),
+                                 jsonString.getNumBytesAsUTF8(), false};
+  return juce::WebBrowserComponent::Resource{
+      streamToVector(stream), juce::String{"application/json"}};
+}
+
+// Page script only names banks: they all live in the user's presets folder
+juce::File getPresetBankFile(const juce::String& name) {
+  constexpr auto EXTENSION = ".wvpb";
+  if (name.isEmpty() || name.containsAnyOf("/\\:") || name.startsWith("."))
+    return {};
+
+  const auto directory =
+      juce::File::getSpecialLocation(juce::File::userApplicationDataDirectory)
+          .getChildFile(JucePlugin_Manufacturer)
+          .getChildFile(JucePlugin_Name)
+          .getChildFile("Presets");
+  if (directory.createDirectory().failed())
+    return {};
+  return directory.getChildFile(
+      name.endsWithIgnoreCase(EXTENSION) ? name : name + EXTENSION);
+}
 
 }  // namespace
 
+/**
+ * @brief Browser that reports when its page has loaded
+ */
+class AudioPluginAudioProcessorEditor::WebView
+    : public juce::WebBrowserComponent {
+public:
+  WebView(const Options& options, std::function<void()> onPageLoaded)
+      : WebBrowserComponent{options}, pageLoaded{std::move(onPageLoaded)} {}
+
+  void pageFinishedLoading(const juce::String&) override { pageLoaded(); }
+
+private:
+  std::function<void()> pageLoaded;
+};
+
 AudioPluginAudioProcessorEditor::AudioPluginAudioProcessorEditor(
     AudioPluginAudioProcessor& p)
     : AudioProcessorEditor(&p),
@@ -103,41 +196,11 @@ AudioPluginAudioProcessorEditor::AudioPluginAudioProcessorEditor(
       bypassButtonAttachment{
           *processorRef.getState().getParameter(id::BYPASS.getParamID()),
           bypassButton, nullptr},
-      webGainRelay{id::GAIN.getParamID()},
-      webBypassRelay{id::BYPASS.getParamID()},
-      webView{
-          juce::WebBrowserComponent::Options{}
-              .withBackend(
-                  juce::WebBrowserComponent::Options::Backend::webview2)
-              .withWinWebView2Options(
-                  juce::WebBrowserComponent::Options::WinWebView2{}
-                      .withBackgroundColour(juce::Colours::white)
-                      .withUserDataFolder(juce::File::getSpecialLocation(
-                          juce::File::SpecialLocationType::tempDirectory)))
-              .withNativeIntegrationEnabled()
-              .withResourceProvider(
-                  [this](const auto& url) { return getResource(url); },
-                  juce::URL{LOCAL_DEV_SERVER_ADDRESS}.getOrigin())
-              .withInitialisationData("vendor", JUCE_COMPANY_NAME)
-              .withInitialisationData("pluginName", JUCE_PRODUCT_NAME)
-              .withInitialisationData("pluginVersion", JUCE_PRODUCT_VERSION)
-              .withNativeFunction(
-                  juce::Identifier{"nativeFunction"},
-                  [this](const juce::Array<juce::var>& args,
-                         juce::WebBrowserComponent::NativeFunctionCompletion
-                             completion) {
-                    nativeFunction(args, std::move(completion));
-                  })
-              .withOptionsFrom(webGainRelay)
-              .withOptionsFrom(webBypassRelay)},
-      webGainSliderAttachment{
-          *processorRef.getState().getParameter(id::GAIN.getParamID()),
-          webGainRelay, nullptr},
-      webBypassToggleAttachment{
-          *processorRef.getState().getParameter(id::BYPASS.getParamID()),
-          webBypassRelay, nullptr} {
-  // Add components to the editor
-  addAndMakeVisible(webView);
+      webParameterRelays{processorRef.getState()} {
+  sentHarmonics.fill(std::numeric_limits<float>::quiet_NaN());
+
+  // The native controls show up right away; the WebView is created after the
+  // first paint, see paint()
   addAndMakeVisible(gainSlider);
   addAndMakeVisible(bypassButton);
   addAndMakeVisible(infoLabel);
@@ -149,65 +212,243 @@ AudioPluginAudioProcessorEditor::AudioPluginAudioProcessorEditor(
   // Configure the window
   setResizable(true, true);
   setSize(800, 600);
-  
+
+  startTimerHz(DEFAULT_METER_FRAME_RATE_HZ);
+  startupTimeline.constructed = getStartupMilliseconds();
+}
+
+AudioPluginAudioProcessorEditor::~AudioPluginAudioProcessorEditor() {
+  processorRef.getSpectrumAnalyzer().stop();
+}
+
+void AudioPluginAudioProcessorEditor::paint(juce::Graphics& g) {
+  g.fillAll(
+      getLookAndFeel().findColour(juce::ResizableWindow::backgroundColourId));
+
+  if (startupTimeline.firstPaint.has_value())
+    return;
+
+  // Starting a browser takes from tens of milliseconds to seconds: let the
+  // native controls reach the screen first
+  startupTimeline.firstPaint = getStartupMilliseconds();
+  juce::MessageManager::callAsync(
+      [editor = juce::Component::SafePointer{this}] {
+        if (editor != nullptr)
+          editor->createWebView();
+      });
+}
+
+void AudioPluginAudioProcessorEditor::createWebView() {
+  const auto options =
+      juce::WebBrowserComponent::Options{}
+          .withBackend(juce::WebBrowserComponent::Options::Backend::webview2)
+          .withWinWebView2Options(
+              juce::WebBrowserComponent::Options::WinWebView2{}
+                  .withBackgroundColour(juce::Colours::white)
+                  .withUserDataFolder(sharedResources->getWebViewDataFolder()))
+          .withNativeIntegrationEnabled()
+          .withResourceProvider(
+              [this](const auto& url) { return getResource(url); },
+              juce::URL{LOCAL_DEV_SERVER_ADDRESS}.getOrigin())
+          .withInitialisationData("vendor", JUCE_COMPANY_NAME)
+          .withInitialisationData("pluginName", JUCE_PRODUCT_NAME)
+          .withInitialisationData("pluginVersion", JUCE_PRODUCT_VERSION)
+          .withNativeFunction(
+              juce::Identifier{"nativeFunction"},
+              [this](const juce::Array<juce::var>& args,
+                     juce::WebBrowserComponent::NativeFunctionCompletion
+                         completion) {
+                nativeFunction(args, std::move(completion));
+              });
+  webView = std::make_unique<WebView>(
+      webParameterRelays.addTo(options), [this] {
+        if (!startupTimeline.pageLoaded.has_value())
+          startupTimeline.pageLoaded = getStartupMilliseconds();
+      });
+  startupTimeline.webViewCreated = getStartupMilliseconds();
+
+  addAndMakeVisible(*webView);
+  resized();
+
   // Load the web UI either from dev server or from bundled resources
-  if (USE_DEV_SERVER) {
+  if (shouldUseDevServer()) {
     // Connect directly to the React dev server for hot reloading
-    webView.goToURL(LOCAL_DEV_SERVER_ADDRESS);
-    infoLabel.setText("DEVELOPMENT MODE: Connected to React dev server", 
-                     juce::dontSendNotification);
+    webView->goToURL(LOCAL_DEV_SERVER_ADDRESS);
+    infoLabel.setText("DEVELOPMENT MODE: Connected to React dev server",
+                      juce::dontSendNotification);
   } else {
-  //   // Use the bundled resources
-    webView.goToURL(juce::WebBrowserComponent::getResourceProviderRoot());
+    webView->goToURL(juce::WebBrowserComponent::getResourceProviderRoot());
   }
 }
 
-AudioPluginAudioProcessorEditor::~AudioPluginAudioProcessorEditor() {}
+double AudioPluginAudioProcessorEditor::getStartupMilliseconds() const {
+  return juce::Time::getMillisecondCounterHiRes() - creationTime;
+}
 
 void AudioPluginAudioProcessorEditor::resized() {
-  auto bounds = getBounds();
-  
+  auto bounds = getLocalBounds();
+
   // Split the view into left and right sections
-  webView.setBounds(bounds.removeFromRight(getWidth() / 2));
-  
+  const auto webViewBounds = bounds.removeFromRight(getWidth() / 2);
+  if (webView != nullptr)
+    webView->setBounds(webViewBounds);
+
   // Layout the native UI components on the left side
   infoLabel.setBounds(bounds.removeFromTop(50).reduced(5));
   gainSlider.setBounds(bounds.removeFromTop(50).reduced(5));
   bypassButton.setBounds(bounds.removeFromTop(50).reduced(10));
-
 }
 
 void AudioPluginAudioProcessorEditor::timerCallback() {
-  // Removed the outputLevel event since we've simplified the UI
+  if (webView != nullptr) {
+    emitMeterFrame();
+    updateSpectrumAnalyzer();
+    emitHarmonicChanges();
+
+    // Programs are also switched by the host
+    if (const auto program = processorRef.getCurrentProgram();
+        program != lastProgram) {
+      lastProgram = program;
+      webView->emitEventIfBrowserIsVisible(getProgramChangedEventId(),
+                                           describePrograms());
+    }
+  }
+
+  const auto sampleRate = processorRef.getSampleRate();
+  const auto addRecord = [this, sampleRate](const auto& record) {
+    profileStatistics.add(record, sampleRate);
+  };
+  processorRef.getProfilerRing().drain(addRecord);
+  processorRef.getSpectrumAnalyzer().getProfilerRing().drain(addRecord);
+}
+
+void AudioPluginAudioProcessorEditor::updateSpectrumAnalyzer() {
+  auto& analyzer = processorRef.getSpectrumAnalyzer();
+
+  // Nobody would see the spectrum: don't compute it at all
+  if (!isShowing()) {
+    if (analyzer.isRunning())
+      analyzer.stop();
+    return;
+  }
+
+  if (!analyzer.isRunning())
+    analyzer.start(spectrumSettings);
+
+  if (const auto frame = analyzer.pullFrame()) {
+    webView->emitEventIfBrowserIsVisible(
+        getSpectrumFrameEventId(),
+        juce::Base64::toBase64(frame->decibels.data(),
+                               sizeof(frame->decibels)));
+  }
+}
+
+void AudioPluginAudioProcessorEditor::emitHarmonicChanges() {
+  // One event per frame however many harmonics the host automates, with the
+  // same (index, value) pairs the web UI sends in "updateHarmonicsDelta"
+  std::array<float, 2 * HarmonicTable::MAX_HARMONICS> changes{};
+  size_t numValues = 0;
+  for (auto i = 0; i < HarmonicTable::MAX_HARMONICS; ++i) {
+    const auto value = processorRef.getHarmonicValue(i);
+    auto& sentValue = sentHarmonics[static_cast<size_t>(i)];
+    if (juce::exactlyEqual(value, sentValue))
+      continue;
+
+    sentValue = value;
+    changes[numValues++] = static_cast<float>(i);
+    changes[numValues++] = value;
+  }
+
+  if (numValues > 0) {
+    webView->emitEventIfBrowserIsVisible(
+        getHarmonicsChangedEventId(),
+        juce::Base64::toBase64(changes.data(), numValues * sizeof(float)));
+  }
+}
+
+void AudioPluginAudioProcessorEditor::emitMeterFrame() {
+  const auto snapshot = processorRef.getLevelMeter().pull();
+  if (!snapshot.has_value())
+    return;
+
+  // Frame layout: the peak levels of all channels, then their RMS levels,
+  // then their true peak levels, then the momentary and the short-term
+  // loudness, as little-endian float32
+  const auto numChannels = static_cast<size_t>(snapshot->numChannels);
+  std::array<float, 3 * MeterSnapshot::MAX_CHANNELS + 2> frame{};
+  auto* position = std::copy_n(snapshot->peak.begin(), numChannels, frame.data());
+  position = std::copy_n(snapshot->rms.begin(), numChannels, position);
+  position = std::copy_n(snapshot->truePeak.begin(), numChannels, position);
+  *position++ = snapshot->momentaryLoudness;
+  *position++ = snapshot->shortTermLoudness;
+  const auto frameSize =
+      static_cast<size_t>(position - frame.data()) * sizeof(float);
+
+  // Nothing to redraw
+  if (lastMeterFrame.matches(frame.data(), frameSize))
+    return;
+
+  lastMeterFrame.replaceAll(frame.data(), frameSize);
+  webView->emitEventIfBrowserIsVisible(
+      getMeterFrameEventId(), juce::Base64::toBase64(frame.data(), frameSize));
 }
 
 auto AudioPluginAudioProcessorEditor::getResource(const juce::String& url) const
     -> std::optional<Resource> {
-  std::cout << "ResourceProvider called with " << url << std::endl;
-
   const auto resourceToRetrieve =
       url == "/" ? "index.html" : url.fromFirstOccurrenceOf("/", false, false);
 
-  if (resourceToRetrieve == "outputLevel.json") {
-    juce::DynamicObject::Ptr levelData{new juce::DynamicObject{}};
-    levelData->setProperty("left", processorRef.outputLevelLeft.load());
-    const auto jsonString = juce::JSON::toString(levelData.get());
-    juce::MemoryInputStream stream{jsonString.getCharPointer(),
-                                   jsonString.getNumBytesAsUTF8(), false};
-    return juce::WebBrowserComponent::Resource{
-        streamToVector(stream), juce::String{"application/json"}};
+  if (resourceToRetrieve == "profile.json") {
+    auto profile = profileStatistics.toVar();
+    if (auto* object = profile.getDynamicObject()) {
+      object->setProperty("enabled", WEBVIEW_PLUGIN_ENABLE_PROFILER != 0);
+      object->setProperty("sampleRate", processorRef.getSampleRate());
+      object->setProperty(
+          "droppedRecords",
+          static_cast<juce::int64>(
+              processorRef.getProfilerRing().getNumDropped()));
+    }
+    return makeJsonResource(profile);
   }
 
-  const auto resource = getWebViewFileAsBytes(resourceToRetrieve);
-  if (!resource.empty()) {
-    const auto extension =
-        resourceToRetrieve.fromLastOccurrenceOf(".", false, false);
-    return Resource{std::move(resource), getMimeForExtension(extension)};
+  if (resourceToRetrieve == "startup.json") {
+    const auto toVar = [](const std::optional<double>& milliseconds) {
+      return milliseconds.has_value() ? juce::var{*milliseconds} : juce::var{};
+    };
+    juce::DynamicObject::Ptr startup{new juce::DynamicObject{}};
+    startup->setProperty("constructedMs", toVar(startupTimeline.constructed));
+    startup->setProperty("firstPaintMs", toVar(startupTimeline.firstPaint));
+    startup->setProperty("webViewCreatedMs",
+                         toVar(startupTimeline.webViewCreated));
+    startup->setProperty("pageLoadedMs", toVar(startupTimeline.pageLoaded));
+    return makeJsonResource(juce::var{startup.get()});
+  }
+
+  if (const auto asset =
+          sharedResources->getAssetStore().get(resourceToRetrieve)) {
+    // Resource owns its data, so this is the only copy of the bytes
+    return Resource{
+        std::vector<std::byte>(asset->bytes.begin(), asset->bytes.end()),
+        asset->mimeType};
   }
 
   return std::nullopt;
 }
 
+juce::var AudioPluginAudioProcessorEditor::describePrograms() const {
+  juce::Array<juce::var> names;
+  if (processorRef.hasPresetBank()) {
+    for (auto i = 0; i < processorRef.getNumPrograms(); ++i) {
+      names.add(processorRef.getProgramName(i));
+    }
+  }
+
+  auto* result = new juce::DynamicObject{};
+  result->setProperty("names", names);
+  result->setProperty("current", processorRef.getCurrentProgram());
+  return result;
+}
+
 void AudioPluginAudioProcessorEditor::nativeFunction(
     const juce::Array<juce::var>& args,
     juce::WebBrowserComponent::NativeFunctionCompletion completion) {
@@ -240,8 +481,11 @@ void AudioPluginAudioProcessorEditor::nativeFunction(
     }
 
     // Pass the harmonic values to the processor
-    auto& processor = static_cast<AudioPluginAudioProcessor&>(*getAudioProcessor());
-    processor.setHarmonicValues(harmonicValues);
+    processorRef.setHarmonicValues(harmonicValues, true);
+    // The web UI has these values already: don't echo them
+    for (auto i = 0; i < HarmonicTable::MAX_HARMONICS; ++i) {
+      sentHarmonics[static_cast<size_t>(i)] = processorRef.getHarmonicValue(i);
+    }
     
     infoLabel.setText(
         "Harmonics updated: " + juce::String(harmonicValues.size()) + " values",
@@ -250,6 +494,180 @@ void AudioPluginAudioProcessorEditor::nativeFunction(
     completion("Harmonics updated successfully");
     return;
   }
+  else if (functionName == "updateHarmonicsDelta")
+  {
+    // Expected format: ["updateHarmonicsDelta", sequenceNumber, deltas], where
+    // deltas is the base64 of float32 (index, value) pairs of the harmonics
+    // that changed
+    if (args.size() < 3 || !args[2].isString())
+    {
+      completion("Error: updateHarmonicsDelta requires a sequence number and "
+                 "base64-encoded deltas");
+      return;
+    }
+
+    // Calls may overtake each other: an older update must not undo a newer one
+    const auto sequenceNumber = static_cast<juce::int64>(args[1]);
+    if (sequenceNumber <= lastHarmonicsSequenceNumber)
+    {
+      completion(lastHarmonicsSequenceNumber);
+      return;
+    }
+
+    const auto numBytes = decodeBase64(
+        args[2].toString(), std::as_writable_bytes(std::span{harmonicDeltas}));
+    if (!numBytes.has_value() || *numBytes % (2 * sizeof(float)) != 0)
+    {
+      completion("Error: malformed harmonic deltas");
+      return;
+    }
+
+    lastHarmonicsSequenceNumber = sequenceNumber;
+    for (size_t i = 0; i < *numBytes / sizeof(float); i += 2) {
+      // Also rejects NaN before it gets converted
+      if (const auto index = harmonicDeltas[i];
+          index >= 0.f && index < HarmonicTable::MAX_HARMONICS) {
+        const auto harmonic = static_cast<int>(index);
+        processorRef.setHarmonicValue(harmonic, harmonicDeltas[i + 1], true);
+        // The web UI has this value already: don't echo it
+        sentHarmonics[static_cast<size_t>(harmonic)] =
+            processorRef.getHarmonicValue(harmonic);
+      }
+    }
+
+    completion(sequenceNumber);
+    return;
+  }
+  else if (functionName == "setSpectrumSettings")
+  {
+    // Expected format: ["setSpectrumSettings", fftOrder, overlap]
+    if (args.size() < 3)
+    {
+      completion("Error: setSpectrumSettings requires an FFT order and an "
+                 "overlap");
+      return;
+    }
+
+    spectrumSettings.fftOrder = static_cast<int>(args[1]);
+    spectrumSettings.overlap = static_cast<int>(args[2]);
+
+    if (auto& analyzer = processorRef.getSpectrumAnalyzer();
+        analyzer.isRunning()) {
+      analyzer.start(spectrumSettings);
+    }
+
+    completion("Spectrum settings updated successfully");
+    return;
+  }
+  else if (functionName == "setEnabledMeters")
+  {
+    // Expected format: ["setEnabledMeters", {peak, rms, truePeak, loudness}]
+    // with a boolean for each meter; meters left out keep their state
+    if (args.size() < 2 || !args[1].isObject())
+    {
+      completion("Error: setEnabledMeters requires an object of booleans");
+      return;
+    }
+
+    auto& levelMeter = processorRef.getLevelMeter();
+    auto meters = levelMeter.getEnabledMeters();
+    const auto setMeter = [&meters, &args](const char* name,
+                                           LevelMeter::Meters meter) {
+      if (!args[1].hasProperty(name))
+        return;
+      meters = static_cast<std::uint8_t>(
+          static_cast<bool>(args[1][name]) ? meters | meter : meters & ~meter);
+    };
+    setMeter("peak", LevelMeter::peak);
+    setMeter("rms", LevelMeter::rms);
+    setMeter("truePeak", LevelMeter::truePeak);
+    setMeter("loudness", LevelMeter::loudness);
+    levelMeter.setEnabledMeters(meters);
+
+    completion(static_cast<int>(meters));
+    return;
+  }
+  else if (functionName == "setMeterFrameRate")
+  {
+    // Expected format: ["setMeterFrameRate", framesPerSecond]
+    if (args.size() < 2 ||
+        !(args[1].isInt() || args[1].isInt64() || args[1].isDouble()))
+    {
+      completion("Error: setMeterFrameRate requires a number");
+      return;
+    }
+
+    startTimerHz(juce::jlimit(MIN_METER_FRAME_RATE_HZ, MAX_METER_FRAME_RATE_HZ,
+                              static_cast<int>(args[1])));
+    completion(getTimerInterval());
+    return;
+  }
+  else if (functionName == "getHarmonics")
+  {
+    // Expected format: ["getHarmonics"], completes with the base64 of all
+    // harmonic values as float32. Later changes arrive as "harmonicsChanged".
+    std::array<float, HarmonicTable::MAX_HARMONICS> values{};
+    for (auto i = 0; i < HarmonicTable::MAX_HARMONICS; ++i) {
+      values[static_cast<size_t>(i)] = sentHarmonics[static_cast<size_t>(i)] =
+          processorRef.getHarmonicValue(i);
+    }
+    completion(juce::Base64::toBase64(values.data(), sizeof(values)));
+    return;
+  }
+  else if (functionName == "getPrograms")
+  {
+    // Expected format: ["getPrograms"], completes with {names, current}
+    completion(describePrograms());
+    return;
+  }
+  else if (functionName == "setCurrentProgram")
+  {
+    // Expected format: ["setCurrentProgram", index]
+    if (args.size() < 2 || !(args[1].isInt() || args[1].isInt64() ||
+                             args[1].isDouble()))
+    {
+      completion("Error: setCurrentProgram requires an index");
+      return;
+    }
+
+    processorRef.setCurrentProgram(static_cast<int>(args[1]));
+    completion(processorRef.getCurrentProgram());
+    return;
+  }
+  else if (functionName == "loadPresetBank" || functionName == "savePresetBank")
+  {
+    // Expected format: ["loadPresetBank", bankName] or
+    // ["savePresetBank", bankName, programName]
+    const auto isSave = functionName == "savePresetBank";
+    if (args.size() < (isSave ? 3 : 2) || !args[1].isString())
+    {
+      completion("Error: " + functionName + " requires a bank name" +
+                 (isSave ? " and a program name" : ""));
+      return;
+    }
+
+    const auto bankName = args[1].toString();
+    const auto file = getPresetBankFile(bankName);
+    if (file == juce::File{})
+    {
+      completion("Error: " + bankName + " is not a valid bank name");
+      return;
+    }
+
+    const auto result = isSave
+                            ? processorRef.savePresetBank(file, args[2].toString())
+                            : processorRef.loadPresetBank(file);
+    if (result.failed())
+    {
+      completion("Error: " + result.getErrorMessage());
+      return;
+    }
+
+    // The names changed even if the index didn't
+    lastProgram = -1;
+    completion(describePrograms());
+    return;
+  }
   else
   {
     // Legacy behavior for other function calls
@@ -1,11 +1,18 @@
 #include "JuceWebViewTutorial/PluginProcessor.h"
 #include <juce_audio_processors/juce_audio_processors.h>
-#include "JuceWebViewTutorial/PluginEditor.h"
 #include "JuceWebViewTutorial/ParameterIDs.hpp"
+#include <algorithm>
+#include <bit>
 #include <cmath>
 #include <functional>
+#include <limits>
+#include <type_traits>
 #include <juce_dsp/juce_dsp.h>
 
+#if !WEBVIEW_PLUGIN_HEADLESS
+#include "JuceWebViewTutorial/PluginEditor.h"
+#endif
+
 namespace webview_plugin {
 AudioPluginAudioProcessor::AudioPluginAudioProcessor()
     : AudioProcessor(
@@ -17,10 +24,18 @@ AudioPluginAudioProcessor::AudioPluginAudioProcessor()
               .withOutput("Output", juce::AudioChannelSet::stereo(), true)
 #endif
               ),
-      state{*this, nullptr, "PARAMETERS", createParameterLayout(parameters)} {
+      state{*this, nullptr, "PARAMETERS",
+            createParameterLayout(parameters, changedHarmonics)} {
+  // Latency depends on the oversampling configuration
+  state.addParameterListener(id::OVERSAMPLING.getParamID(), this);
+  state.addParameterListener(id::OVERSAMPLING_FILTER.getParamID(), this);
 }
 
-AudioPluginAudioProcessor::~AudioPluginAudioProcessor() {}
+AudioPluginAudioProcessor::~AudioPluginAudioProcessor() {
+  state.removeParameterListener(id::OVERSAMPLING.getParamID(), this);
+  state.removeParameterListener(id::OVERSAMPLING_FILTER.getParamID(), this);
+  cancelPendingUpdate();
+}
 
 const juce::String AudioPluginAudioProcessor::getName() const {
   return JucePlugin_Name;
@@ -55,22 +70,27 @@ double AudioPluginAudioProcessor::getTailLengthSeconds() const {
 }
 
 int AudioPluginAudioProcessor::getNumPrograms() {
-  return 1;  // NB: some hosts don't cope very well if you tell them there are 0
-             // programs, so this should be at least 1, even if you're not
-             // really implementing programs.
+  // NB: some hosts don't cope very well if you tell them there are 0
+  // programs, so this should be at least 1, even without a bank
+  return programs != nullptr ? juce::jmax(1, static_cast<int>(programs->size()))
+                             : 1;
 }
 
 int AudioPluginAudioProcessor::getCurrentProgram() {
-  return 0;
+  return requestedProgram.load(std::memory_order_relaxed);
 }
 
 void AudioPluginAudioProcessor::setCurrentProgram(int index) {
-  juce::ignoreUnused(index);
+  // Some hosts call this on the audio thread: the switch itself happens in
+  // processBlock(), see updateProgram()
+  requestedProgram.store(index, std::memory_order_relaxed);
 }
 
 const juce::String AudioPluginAudioProcessor::getProgramName(int index) {
-  juce::ignoreUnused(index);
-  return {};
+  if (programs == nullptr ||
+      !juce::isPositiveAndBelow(index, static_cast<int>(programs->size())))
+    return {};
+  return (*programs)[static_cast<size_t>(index)].name;
 }
 
 void AudioPluginAudioProcessor::changeProgramName(int index,
@@ -80,19 +100,39 @@ void AudioPluginAudioProcessor::changeProgramName(int index,
 
 void AudioPluginAudioProcessor::prepareToPlay(double sampleRate,
                                               int samplesPerBlock) {
-  using namespace juce;
-
-  envelopeFollower.prepare(dsp::ProcessSpec{
-      .sampleRate = sampleRate,
-      .maximumBlockSize = static_cast<uint32>(samplesPerBlock),
-      .numChannels = static_cast<uint32>(getTotalNumOutputChannels())});
-  envelopeFollower.setAttackTime(200.f);
-  envelopeFollower.setReleaseTime(200.f);
-  envelopeFollower.setLevelCalculationType(
-      dsp::BallisticsFilter<float>::LevelCalculationType::peak);
-
-  envelopeFollowerOutputBuffer.setSize(getTotalNumOutputChannels(),
-                                       samplesPerBlock);
+  levelMeter.prepare(sampleRate, getChannelLayoutOfBus(false, 0),
+                     samplesPerBlock);
+  spectrumAnalyzer.setSampleRate(sampleRate);
+
+  harmonicGenerator.prepare();
+  sentHarmonicMidi = false;
+  wetStagesReset = false;
+  additiveSynth.prepare(sampleRate, samplesPerBlock);
+  changedHarmonics.fetch_or(~std::uint64_t{}, std::memory_order_relaxed);
+  updateHarmonics();
+
+  programGain.reset(sampleRate, PROGRAM_FADE_SECONDS);
+  programGainRamp.resize(static_cast<size_t>(juce::jmax(1, samplesPerBlock)));
+
+  oversampling.prepare(getTotalNumOutputChannels(), samplesPerBlock);
+  updateLatency();
+
+  outputStage.prepare(sampleRate, samplesPerBlock,
+                      getChannelLayoutOfBus(false, 0));
+  outputStage.reset(parameters.gain->get(), parameters.pan->get());
+
+  // The dry signal is delayed as much as any oversampling configuration
+  auto maxLatency = 0;
+  for (auto factor = 0; factor < OversamplingStage::NUM_FACTORS; ++factor) {
+    for (const auto filterType : {OversamplingStage::FilterType::polyphaseIir,
+                                  OversamplingStage::FilterType::firEquiripple}) {
+      maxLatency = juce::jmax(
+          maxLatency, oversampling.getLatencyInSamples(factor, filterType));
+    }
+  }
+  bypassCrossfade.prepare(sampleRate, getTotalNumOutputChannels(),
+                          samplesPerBlock, maxLatency);
+  bypassCrossfade.reset(parameters.bypass->get());
 }
 
 void AudioPluginAudioProcessor::releaseResources() {
@@ -106,12 +146,10 @@ bool AudioPluginAudioProcessor::isBusesLayoutSupported(
   juce::ignoreUnused(layouts);
   return true;
 #else
-  // This is the place where you check if the layout is supported.
-  // In this template code we only support mono or stereo.
-  // Some plugin hosts, such as certain GarageBand versions, will only
-  // load plugins that support stereo bus layouts.
-  if (layouts.getMainOutputChannelSet() != juce::AudioChannelSet::mono() &&
-      layouts.getMainOutputChannelSet() != juce::AudioChannelSet::stereo())
+  // Any layout up to MAX_CHANNELS, from mono to 7.1.4 and beyond. See
+  // OutputStage::getPanSides() for how pan applies to each of them.
+  const auto& outputLayout = layouts.getMainOutputChannelSet();
+  if (outputLayout.isDisabled() || outputLayout.size() > MAX_CHANNELS)
     return false;
 
     // This checks if the input layout matches the output layout
@@ -126,6 +164,8 @@ bool AudioPluginAudioProcessor::isBusesLayoutSupported(
 
 void AudioPluginAudioProcessor::processBlock(juce::AudioBuffer<float>& buffer,
                                              juce::MidiBuffer& midiMessages) {
+  WEBVIEW_PROFILE_SCOPE(profilerRing, ProfilerStage::block,
+                        buffer.getNumSamples());
   juce::ScopedNoDenormals noDenormals;
   auto totalNumInputChannels = getTotalNumInputChannels();
   auto totalNumOutputChannels = getTotalNumOutputChannels();
@@ -135,210 +175,596 @@ void AudioPluginAudioProcessor::processBlock(juce::AudioBuffer<float>& buffer,
   for (auto i = totalNumInputChannels; i < totalNumOutputChannels; ++i)
     buffer.clear(i, 0, buffer.getNumSamples());
 
-  // Process MIDI with harmonics
-  if (harmonicEnabled) {
-    juce::MidiBuffer processedMidi;
-    const juce::ScopedLock lock(harmonicLock);
-    
-    for (const auto metadata : midiMessages) {
-      const auto message = metadata.getMessage();
-      const auto time = metadata.samplePosition;
-      
-      // Add the original MIDI message to our output buffer
-      processedMidi.addEvent(message, time);
-      
-      if (message.isNoteOn()) {
-        // Create a new ActiveNote entry to track this note and its harmonics
-        auto* activeNote = new ActiveNote();
-        activeNote->rootNote = message.getNoteNumber();
-        
-        // Calculate velocities for harmonic notes based on our harmonicValues
-        const int velocity = message.getVelocity();
-        
-        // Process each harmonic (skip the first one as it's the fundamental)
-        for (int h = 1; h < harmonicValues.size(); ++h) {
-          // Calculate the note for this harmonic
-          // (harmonic n = n times the fundamental frequency)
-          const float normalizedHarmonicValue = harmonicValues[h] / 100.0f; // Convert 0-100 to 0-1
-          
-          if (normalizedHarmonicValue > 0.01f) { // Only add harmonics with sufficient amplitude
-            // Calculate the MIDI note number for this harmonic
-            // Each octave is 12 semitones, log2(n) gives how many octaves above the fundamental
-            const float harmonicMultiple = h + 1; // Harmonic index + 1 (e.g., h=1 is the 2nd harmonic)
-            const float harmonicSemitones = 12.0f * std::log2(harmonicMultiple);
-            
-            // Round to nearest semitone
-            const int semitonesUp = std::round(harmonicSemitones);
-            int harmonicNote = message.getNoteNumber() + semitonesUp;
-            
-            // Ensure we don't exceed MIDI note range (0-127)
-            if (harmonicNote > 127) 
-              continue;
-            
-            // Set velocity based on the harmonic value (scaled by the original note velocity)
-            const int harmonicVelocity = juce::jlimit(1, 127, 
-              static_cast<int>(velocity * normalizedHarmonicValue));
-            
-            // Create MIDI note on for this harmonic
-            const juce::MidiMessage harmonicNoteOn = juce::MidiMessage::noteOn(
-              message.getChannel(), 
-              harmonicNote, 
-              static_cast<juce::uint8>(harmonicVelocity));
-            
-            // Add to the processed buffer
-            processedMidi.addEvent(harmonicNoteOn, time);
-            
-            // Track this harmonic note
-            activeNote->harmonicNotes.add(harmonicNote);
-          }
-        }
-        
-        // Store this active note
-        activeNotes.add(activeNote);
-      }
-      else if (message.isNoteOff()) {
-        // Find the corresponding active note
-        const int noteNumber = message.getNoteNumber();
-        
-        for (int i = activeNotes.size() - 1; i >= 0; --i) {
-          if (activeNotes[i]->rootNote == noteNumber) {
-            // Generate note offs for all harmonics of this note
-            for (const auto& harmonicNote : activeNotes[i]->harmonicNotes) {
-              const juce::MidiMessage harmonicNoteOff = juce::MidiMessage::noteOff(
-                message.getChannel(), harmonicNote);
-              processedMidi.addEvent(harmonicNoteOff, time);
-            }
-            
-            // Remove from active notes
-            activeNotes.remove(i);
-          }
-        }
-      }
-      else if (message.isAllNotesOff()) {
-        // Clear all active notes on all notes off message
-        activeNotes.clear();
+  updateHarmonics();
+
+  const auto renderSynth =
+      harmonicEnabled &&
+      static_cast<HarmonicEngine>(readAudioSettings().harmonicEngine) ==
+          HarmonicEngine::additive;
+
+  // Process MIDI with harmonics, either as extra notes or as partials of the
+  // internal synth
+  if (!renderSynth)
+    additiveSynth.reset();
+
+  const auto sendHarmonicMidi = harmonicEnabled && !renderSynth;
+  if (sendHarmonicMidi) {
+    WEBVIEW_PROFILE_SCOPE(profilerRing, ProfilerStage::harmonicMidi,
+                          buffer.getNumSamples());
+    harmonicGenerator.process(midiMessages, *activeVoicingPlan);
+  } else if (sentHarmonicMidi) {
+    // Nothing releases the harmonics of held notes once they're not sent
+    harmonicGenerator.releaseAll(midiMessages);
+  }
+  sentHarmonicMidi = sendHarmonicMidi;
+
+  if (buffer.getNumSamples() == 0) {
+    return;
+  }
+
+  {
+    WEBVIEW_PROFILE_SCOPE(profilerRing, ProfilerStage::distortion,
+                          buffer.getNumSamples());
+
+    const auto block =
+        juce::dsp::AudioBlock<float>{buffer}.getSubsetChannelBlock(
+            0u, static_cast<size_t>(totalNumOutputChannels));
+    // Sub-blocks start at every MIDI event, so the synth's notes start and
+    // stop sample-accurately
+    auto midiEvent = midiMessages.cbegin();
+    const auto handleMidiEventsBefore = [&](int end) {
+      for (; midiEvent != midiMessages.cend() &&
+             (*midiEvent).samplePosition < end;
+           ++midiEvent) {
+        // The synth can't release notes while the wet path doesn't run
+        if (renderSynth && !bypassCrossfade.isFullyBypassed())
+          additiveSynth.handleMidiEvent((*midiEvent).getMessage());
       }
+    };
+
+    forEachSubBlock(buffer.getNumSamples(), midiMessages,
+                    maxSubBlockSize.load(std::memory_order_relaxed),
+                    [&](int start, int length) {
+                      updateProgram();
+                      const auto settings = readAudioSettings();
+                      // Before the sub-block's MIDI, which depends on it
+                      bypassCrossfade.setBypassed(settings.bypass);
+                      handleMidiEventsBefore(start + length);
+
+                      const auto subBlock =
+                          block.getSubBlock(static_cast<size_t>(start),
+                                            static_cast<size_t>(length));
+                      processSubBlock(subBlock, settings, renderSynth);
+                      if (programFade != ProgramFade::none)
+                        applyProgramFade(subBlock);
+                    });
+    // Events past the end of the block, e.g., note-offs from sloppy hosts
+    handleMidiEventsBefore(std::numeric_limits<int>::max());
+  }
+
+  // The output is metered even when bypassed
+  WEBVIEW_PROFILE_SCOPE(profilerRing, ProfilerStage::metering,
+                        buffer.getNumSamples());
+  const auto outputBlock =
+      juce::dsp::AudioBlock<float>{buffer}.getSubsetChannelBlock(
+          0u, static_cast<size_t>(getTotalNumOutputChannels()));
+  levelMeter.process(outputBlock);
+  spectrumAnalyzer.pushSamples(outputBlock);
+}
+
+void AudioPluginAudioProcessor::processSubBlock(
+    juce::dsp::AudioBlock<float> block,
+    const AudioSettings& settings,
+    bool renderSynth) {
+  // Parameters are read again for every sub-block, so that their changes take
+  // effect within maxSubBlockSize samples. processBlock() has set the bypass
+  // state already.
+  if (bypassCrossfade.isFullyBypassed()) {
+    // The wet stages don't run: once they do again, they start from silence
+    // instead of their state from before the bypass
+    if (!wetStagesReset) {
+      additiveSynth.reset();
+      oversampling.reset();
+      outputStage.reset(settings.gain, settings.pan);
+      wetStagesReset = true;
     }
-    
-    // Replace the original MIDI buffer with our processed one
-    midiMessages.swapWith(processedMidi);
+  } else {
+    wetStagesReset = false;
   }
 
-  if (parameters.bypass->get() || buffer.getNumSamples() == 0) {
+  // Keeps the dry signal aligned with the latency reported to the host
+  bypassCrossfade.setDryDelay(oversampling.getLatencyInSamples(
+      settings.oversampling,
+      static_cast<OversamplingStage::FilterType>(settings.oversamplingFilter)));
+  bypassCrossfade.process(block, [this, &settings, renderSynth](
+                                     juce::dsp::AudioBlock<float> wet) {
+    // The synth's output is shaped like the input it's mixed with
+    if (renderSynth) {
+      WEBVIEW_PROFILE_SCOPE(profilerRing, ProfilerStage::additive,
+                            static_cast<int>(wet.getNumSamples()));
+      additiveSynth.render(wet);
+    }
+
+    outputStage.setTargets(settings.gain, settings.pan);
+
+    const auto shaperType =
+        settings.harmonicExciter
+            ? ShaperType::chebyshev
+            : static_cast<ShaperType>(settings.distortionType);
+    const auto oversamplingFactor = settings.oversampling;
+
+    if (oversamplingFactor == 0 && shaperType == ShaperType::chebyshev) {
+      // Vectorized across samples, which fusing can't do
+      waveshaper.process(wet, shaperType);
+      outputStage.process(wet, IdentityShape{});
+    } else if (oversamplingFactor == 0) {
+      // Shaper, gain and pan in a single pass over the samples
+      waveshaper.visit(shaperType, [this, wet](const auto& shape) {
+        outputStage.process(wet, shape);
+      });
+    } else {
+      // Only the shaper runs oversampled: it's the only nonlinear stage
+      oversampling.process(
+          wet, oversamplingFactor,
+          static_cast<OversamplingStage::FilterType>(
+              settings.oversamplingFilter),
+          [this, shaperType](juce::dsp::AudioBlock<float> oversampledBlock) {
+            waveshaper.process(oversampledBlock, shaperType);
+          });
+      outputStage.process(wet, IdentityShape{});
+    }
+  });
+}
+
+AudioSettings AudioPluginAudioProcessor::readAudioSettings() const noexcept {
+  if (const auto* program = unsyncedProgram.load(std::memory_order_acquire))
+    return program->settings;
+
+  return {.gain = parameters.gain->get(),
+          .pan = parameters.pan->get(),
+          .bypass = parameters.bypass->get(),
+          .distortionType = parameters.distortionType->getIndex(),
+          .oversampling = parameters.oversampling->getIndex(),
+          .oversamplingFilter = parameters.oversamplingFilter->getIndex(),
+          .harmonicEngine = parameters.harmonicEngine->getIndex(),
+          .harmonicExciter = parameters.harmonicExciter->get()};
+}
+
+void AudioPluginAudioProcessor::updateProgram() noexcept {
+  if (programs == nullptr)
     return;
+
+  const auto requested = requestedProgram.load(std::memory_order_relaxed);
+  const auto isValid =
+      juce::isPositiveAndBelow(requested, static_cast<int>(programs->size()));
+
+  switch (programFade) {
+    case ProgramFade::none:
+      if (isValid && requested != activeProgram) {
+        programFade = ProgramFade::out;
+        programGain.setTargetValue(0.f);
+      }
+      break;
+    case ProgramFade::out:
+      if (programGain.isSmoothing())
+        break;
+
+      // Silent now: switch everything at once
+      if (isValid) {
+        applyProgram((*programs)[static_cast<size_t>(requested)]);
+        activeProgram = requested;
+      }
+      programFade = ProgramFade::in;
+      programGain.setTargetValue(1.f);
+      break;
+    case ProgramFade::in:
+      if (!programGain.isSmoothing())
+        programFade = ProgramFade::none;
+      break;
   }
+}
+
+void AudioPluginAudioProcessor::applyProgram(
+    const ProgramSnapshot& program) noexcept {
+  // Only pointers and fixed-size copies: the snapshot is ready to use
+  activeVoicingPlan = &program.voicingPlan;
+  additiveSynth.setPlan(program.partialPlan);
+  waveshaper.setPolynomial(program.polynomial);
+  setRootNote(program.state.rootNote);
+  setHarmonicEnabled(program.state.harmonicEnabled);
+
+  // No glides from the previous program's gain, pan and bypass state
+  outputStage.reset(program.settings.gain, program.settings.pan);
+  bypassCrossfade.reset(program.settings.bypass);
+
+  unsyncedProgram.store(&program, std::memory_order_release);
+  triggerAsyncUpdate();
+}
 
-  juce::dsp::AudioBlock<float> block{buffer};
-  if (parameters.distortionType->getIndex() == 1) {
-    // tanh(kx)/tanh(k)
-    juce::dsp::AudioBlock<float>::process(block, block, [](float sample) {
-      constexpr auto SATURATION = 5.f;
-      static const auto normalizationFactor = std::tanh(SATURATION);
-      sample = std::tanh(SATURATION * sample) / normalizationFactor;
-      return sample;
-    });
-  } else if (parameters.distortionType->getIndex() == 2) {
-    // sigmoid
-    juce::dsp::AudioBlock<float>::process(block, block, [](float sample) {
-      constexpr auto SATURATION = 5.f;
-      sample = 2.f / (1.f + std::exp(-SATURATION * sample)) - 1.f;
-      return sample;
-    });
+void AudioPluginAudioProcessor::applyProgramFade(
+    juce::dsp::AudioBlock<float> block) noexcept {
+  // Computed in chunks that fit the ramp buffer
+  const auto maxChunkSize = programGainRamp.size();
+  for (size_t start = 0; start < block.getNumSamples(); start += maxChunkSize) {
+    const auto chunkSize = std::min(maxChunkSize, block.getNumSamples() - start);
+    for (size_t i = 0; i < chunkSize; ++i) {
+      programGainRamp[i] = programGain.getNextValue();
+    }
+
+    for (size_t channel = 0; channel < block.getNumChannels(); ++channel) {
+      juce::FloatVectorOperations::multiply(
+          block.getChannelPointer(channel) + start, programGainRamp.data(),
+          static_cast<int>(chunkSize));
+    }
   }
+}
+
+void AudioPluginAudioProcessor::updateHarmonics() noexcept {
+  // Older changes don't replace the plans of a program switched to until the
+  // parameters reflect it
+  if (unsyncedProgram.load(std::memory_order_acquire) != nullptr)
+    return;
+
+  auto changed = changedHarmonics.exchange(0, std::memory_order_acquire);
+  if (changed == 0)
+    return;
 
-  buffer.applyGain(parameters.gain->get());
-
-  // Apply panning
-  if (buffer.getNumChannels() >= 2) {
-    // Convert pan parameter from 0-1 range to -1 to 1 range
-    const float panValue = 2.0f * parameters.pan->get() - 1.0f; // -1 (left) to 1 (right)
-    
-    // Apply equal power panning
-    const float leftGain = std::cos((panValue + 1.0f) * juce::MathConstants<float>::pi * 0.25f);
-    const float rightGain = std::sin((panValue + 1.0f) * juce::MathConstants<float>::pi * 0.25f);
-    
-    buffer.applyGain(0, 0, buffer.getNumSamples(), leftGain);
-    buffer.applyGain(1, 0, buffer.getNumSamples(), rightGain);
+  for (; changed != 0; changed &= changed - 1) {
+    const auto index = std::countr_zero(changed);
+    harmonicValues.values[static_cast<size_t>(index)] =
+        parameters.harmonics[static_cast<size_t>(index)]->get();
   }
 
-  const auto inBlock =
-      juce::dsp::AudioBlock<float>{buffer}.getSubsetChannelBlock(
-          0u, static_cast<size_t>(getTotalNumOutputChannels()));
-  auto outBlock =
-      juce::dsp::AudioBlock<float>{envelopeFollowerOutputBuffer}.getSubBlock(
-          0u, static_cast<size_t>(buffer.getNumSamples()));
-  envelopeFollower.process(
-      juce::dsp::ProcessContextNonReplacing<float>{inBlock, outBlock});
-  outputLevelLeft = juce::Decibels::gainToDecibels(
-      outBlock.getSample(0, static_cast<int>(outBlock.getNumSamples()) - 1));
+  voicingPlan = VoicingPlan::compile(harmonicValues);
+  partialPlan = PartialPlan::compile(harmonicValues);
+  chebyshevPolynomial = ChebyshevPolynomial::compile(harmonicValues);
+  activeVoicingPlan = &voicingPlan;
+  additiveSynth.setPlan(partialPlan);
+  waveshaper.setPolynomial(chebyshevPolynomial);
 }
 
 bool AudioPluginAudioProcessor::hasEditor() const {
-  return true;  // (change this to false if you choose to not supply an editor)
+  // (change this to false if you choose to not supply an editor)
+  return !WEBVIEW_PLUGIN_HEADLESS;
 }
 
 juce::AudioProcessorEditor* AudioPluginAudioProcessor::createEditor() {
+#if WEBVIEW_PLUGIN_HEADLESS
+  return nullptr;
+#else
   return new AudioPluginAudioProcessorEditor(*this);
+#endif
 }
 
 void AudioPluginAudioProcessor::getStateInformation(
     juce::MemoryBlock& destData) {
-  // You should use this method to store your parameters in the memory block.
-  // You could do that either as raw data, or use the XML or ValueTree classes
-  // as intermediaries to make it easy to save and load complex data.
-  juce::ignoreUnused(destData);
+  // Written straight into the host's block: no XML or ValueTree in between
+  juce::MemoryOutputStream stream{destData, false};
+  state_format::write(captureState(), stream);
 }
 
 void AudioPluginAudioProcessor::setStateInformation(const void* data,
                                                     int sizeInBytes) {
-  // You should use this method to restore your parameters from this memory
-  // block, whose contents will have been created by the getStateInformation()
-  // call.
-  juce::ignoreUnused(data, sizeInBytes);
+  // Parse into a staging copy first so that a corrupt state changes nothing
+  auto newState = captureState();
+  if (sizeInBytes <= 0 ||
+      state_format::read(data, static_cast<size_t>(sizeInBytes), newState)
+          .failed())
+    return;
+
+  restoreState(newState);
+}
+
+ProcessorState AudioPluginAudioProcessor::captureState() const {
+  ProcessorState result;
+
+  for (const auto* parameter : getParameters()) {
+    if (const auto* ranged =
+            dynamic_cast<const juce::RangedAudioParameter*>(parameter)) {
+      result.parameters.emplace_back(
+          ranged->getParameterID(),
+          ranged->convertFrom0to1(ranged->getValue()));
+    }
+  }
+
+  // Also stored as a table, for versions without harmonic parameters
+  result.harmonics.size = HarmonicTable::MAX_HARMONICS;
+  for (auto i = 0; i < HarmonicTable::MAX_HARMONICS; ++i) {
+    result.harmonics.values[static_cast<size_t>(i)] = getHarmonicValue(i);
+  }
+  result.rootNote = rootNote;
+  result.harmonicEnabled = harmonicEnabled;
+  return result;
+}
+
+void AudioPluginAudioProcessor::restoreState(const ProcessorState& newState) {
+  // Compiled like a program, so that the audio thread switches to the whole
+  // state at once instead of rendering with half-restored parameters
+  auto snapshot = std::make_unique<const ProgramSnapshot>(
+      compileProgram(preset_bank::Preset{.state = newState}));
+  {
+    // Waits for the current block at most; switching takes no time
+    const juce::ScopedLock lock{getCallbackLock()};
+    applyProgram(*snapshot);
+    // A program switch underway would replace the restored state
+    activeProgram = requestedProgram.load(std::memory_order_relaxed);
+    programFade = ProgramFade::none;
+    programGain.setCurrentAndTargetValue(1.f);
+    // Nothing points into the previous restored state any more
+    std::swap(restoredState, snapshot);
+  }
+
+  // Right away rather than asynchronously, so that the state reads back as
+  // restored. The audio thread reads the snapshot until this is done.
+  syncProgram();
 }
 
 juce::AudioProcessorValueTreeState::ParameterLayout
 AudioPluginAudioProcessor::createParameterLayout(
-    AudioPluginAudioProcessor::Parameters& parameters) {
-  using namespace juce;
-  AudioProcessorValueTreeState::ParameterLayout layout;
+    AudioPluginAudioProcessor::Parameters& parameters,
+    std::atomic<std::uint64_t>& changedHarmonics) {
+  juce::AudioProcessorValueTreeState::ParameterLayout layout;
 
-  {
-    auto parameter = std::make_unique<AudioParameterFloat>(
-        id::GAIN, "gain", NormalisableRange<float>{0.f, 1.f, 0.01f, 0.9f}, 1.f);
-    parameters.gain = parameter.get();
+  for (const auto& spec : getParameterSpecs()) {
+    auto parameter = createParameter(spec, changedHarmonics);
+    bindParameter(parameters, spec, *parameter);
     layout.add(std::move(parameter));
   }
 
-  {
-    auto parameter = std::make_unique<AudioParameterBool>(
-        id::BYPASS, "bypass", false,
-        AudioParameterBoolAttributes{}.withLabel("Bypass"));
-    parameters.bypass = parameter.get();
-    layout.add(std::move(parameter));
+  return layout;
+}
+
+void AudioPluginAudioProcessor::bindParameter(
+    AudioPluginAudioProcessor::Parameters& parameters,
+    const ParameterSpec& spec,
+    juce::RangedAudioParameter& parameter) {
+  if (spec.harmonicIndex >= 0) {
+    parameters.harmonics[static_cast<size_t>(spec.harmonicIndex)] =
+        dynamic_cast<HarmonicParameter*>(&parameter);
+    return;
+  }
+
+  const auto bind = [&spec, &parameter](const juce::ParameterID& parameterId,
+                                        auto*& field) {
+    if (spec.id.getParamID() == parameterId.getParamID())
+      field = dynamic_cast<std::remove_reference_t<decltype(field)>>(&parameter);
+  };
+  bind(id::GAIN, parameters.gain);
+  bind(id::BYPASS, parameters.bypass);
+  bind(id::DISTORTION_TYPE, parameters.distortionType);
+  bind(id::PAN, parameters.pan);
+  bind(id::OVERSAMPLING, parameters.oversampling);
+  bind(id::OVERSAMPLING_FILTER, parameters.oversamplingFilter);
+  bind(id::HARMONIC_ENGINE, parameters.harmonicEngine);
+  bind(id::HARMONIC_EXCITER, parameters.harmonicExciter);
+}
+
+void AudioPluginAudioProcessor::parameterChanged(const juce::String&, float) {
+  // May be called on the audio thread: report the latency from the message
+  // thread instead
+  triggerAsyncUpdate();
+}
+
+void AudioPluginAudioProcessor::handleAsyncUpdate() {
+  syncProgram();
+  updateLatency();
+}
+
+void AudioPluginAudioProcessor::syncProgram() {
+  const auto* program = unsyncedProgram.load(std::memory_order_acquire);
+  if (program == nullptr)
+    return;
+
+  // The audio thread keeps using the snapshot's settings until this is done
+  const auto& processorParameters = getParameters();
+  for (auto i = 0; i < processorParameters.size(); ++i) {
+    processorParameters[i]->setValueNotifyingHost(
+        program->normalizedValues[static_cast<size_t>(i)]);
   }
 
+  // Unless the audio thread has switched to yet another program meanwhile
+  unsyncedProgram.compare_exchange_strong(program, nullptr,
+                                          std::memory_order_acq_rel);
+  updateHostDisplay(ChangeDetails{}.withProgramChanged(true));
+}
+
+ProgramSnapshot AudioPluginAudioProcessor::compileProgram(
+    const preset_bank::Preset& preset) const {
+  ProgramSnapshot program{.name = preset.name, .state = preset.state};
+
+  // Parameters missing from the preset take their default values
+  const auto& processorParameters = getParameters();
+  program.normalizedValues.reserve(
+      static_cast<size_t>(processorParameters.size()));
+  for (const auto* parameter : processorParameters) {
+    auto value = parameter->getDefaultValue();
+    if (const auto* ranged =
+            dynamic_cast<const juce::RangedAudioParameter*>(parameter)) {
+      const auto& presetParameters = preset.state.parameters;
+      const auto stored = std::find_if(
+          presetParameters.begin(), presetParameters.end(),
+          [ranged](const auto& entry) {
+            return entry.first == ranged->getParameterID();
+          });
+      if (stored != presetParameters.end())
+        value = ranged->convertTo0to1(stored->second);
+    }
+    program.normalizedValues.push_back(value);
+  }
+
+  // The table wins over the harmonic parameters: states from versions without
+  // harmonic parameters only have the table
+  const auto& harmonics = preset.state.harmonics;
+  for (const auto* parameter : parameters.harmonics) {
+    const auto index = parameter->getHarmonicIndex();
+    program.normalizedValues[static_cast<size_t>(
+        parameter->getParameterIndex())] = parameter->convertTo0to1(
+        index < harmonics.size ? harmonics.values[static_cast<size_t>(index)]
+                               : 0.f);
+  }
+
+  const auto getValue = [&program](const juce::RangedAudioParameter& parameter) {
+    return parameter.convertFrom0to1(program.normalizedValues[static_cast<size_t>(
+        parameter.getParameterIndex())]);
+  };
+  const auto getIndex = [&getValue](const juce::RangedAudioParameter& parameter) {
+    return juce::roundToInt(getValue(parameter));
+  };
+  program.settings = {
+      .gain = getValue(*parameters.gain),
+      .pan = getValue(*parameters.pan),
+      .bypass = getValue(*parameters.bypass) >= 0.5f,
+      .distortionType = getIndex(*parameters.distortionType),
+      .oversampling = getIndex(*parameters.oversampling),
+      .oversamplingFilter = getIndex(*parameters.oversamplingFilter),
+      .harmonicEngine = getIndex(*parameters.harmonicEngine),
+      .harmonicExciter = getValue(*parameters.harmonicExciter) >= 0.5f};
+
+  program.voicingPlan = VoicingPlan::compile(preset.state.harmonics);
+  program.partialPlan = PartialPlan::compile(preset.state.harmonics);
+  program.polynomial = ChebyshevPolynomial::compile(preset.state.harmonics);
+  return program;
+}
+
+juce::Result AudioPluginAudioProcessor::loadPresetBank(const juce::File& file) {
+  std::unique_ptr<const std::vector<ProgramSnapshot>> newPrograms;
+  if (const auto result = readPresetBank(file, newPrograms); result.failed())
+    return result;
+
+  swapPrograms(std::move(newPrograms), -1);
+  return juce::Result::ok();
+}
+
+juce::Result AudioPluginAudioProcessor::readPresetBank(
+    const juce::File& file,
+    std::unique_ptr<const std::vector<ProgramSnapshot>>& newPrograms) const {
+  preset_bank::Reader reader;
+  if (const auto result = reader.open(file); result.failed())
+    return result;
+
+  // Everything is parsed and compiled here, before the audio thread sees it
+  ProcessorState defaults;
+  for (const auto* parameter : getParameters()) {
+    if (const auto* ranged =
+            dynamic_cast<const juce::RangedAudioParameter*>(parameter)) {
+      defaults.parameters.emplace_back(
+          ranged->getParameterID(),
+          ranged->convertFrom0to1(ranged->getDefaultValue()));
+    }
+  }
+
+  auto compiledPrograms = std::make_unique<std::vector<ProgramSnapshot>>();
+  compiledPrograms->reserve(static_cast<size_t>(reader.getNumPresets()));
+  for (auto i = 0; i < reader.getNumPresets(); ++i) {
+    preset_bank::Preset preset{.state = defaults};
+    if (const auto result = reader.read(i, preset); result.failed())
+      return result;
+    compiledPrograms->push_back(compileProgram(preset));
+  }
+
+  newPrograms = std::move(compiledPrograms);
+  return juce::Result::ok();
+}
+
+void AudioPluginAudioProcessor::swapPrograms(
+    std::unique_ptr<const std::vector<ProgramSnapshot>> newPrograms,
+    int currentProgram) {
+  auto oldPrograms = std::move(newPrograms);
   {
-    auto parameter = std::make_unique<AudioParameterChoice>(
-        id::DISTORTION_TYPE, "distortion type",
-        StringArray{"none", "tanh(kx)/tanh(k)", "sigmoid"}, 0);
-    parameters.distortionType = parameter.get();
-    layout.add(std::move(parameter));
+    // Waits for the current block at most; the swap itself takes no time
+    const juce::ScopedLock lock{getCallbackLock()};
+    std::swap(programs, oldPrograms);
+    unsyncedProgram.store(nullptr, std::memory_order_release);
+    // Back to the plans of the harmonic parameters, before the old programs
+    // the audio thread may point into are gone
+    changedHarmonics.fetch_or(~std::uint64_t{}, std::memory_order_relaxed);
+    updateHarmonics();
+    if (currentProgram < 0) {
+      activeProgram = -1;
+      programFade = ProgramFade::none;
+      programGain.setCurrentAndTargetValue(1.f);
+      requestedProgram.store(0, std::memory_order_relaxed);
+    } else {
+      // The parameters already hold this program: no switch, no fade
+      activeProgram = currentProgram;
+      requestedProgram.store(currentProgram, std::memory_order_relaxed);
+    }
   }
 
+  updateHostDisplay(ChangeDetails{}.withProgramChanged(true));
+}
+
+juce::Result AudioPluginAudioProcessor::savePresetBank(
+    const juce::File& file,
+    const juce::String& newProgramName) {
+  std::vector<preset_bank::Preset> presets;
+  if (programs != nullptr) {
+    for (const auto& program : *programs) {
+      presets.push_back({.name = program.name, .state = program.state});
+    }
+  }
+  if (presets.size() >= static_cast<size_t>(preset_bank::MAX_PRESETS))
+    return juce::Result::fail("The bank is full");
+  presets.push_back({.name = newProgramName, .state = captureState()});
+
+  // Replace the bank only once it's complete
+  juce::TemporaryFile temporaryFile{file};
   {
-    auto parameter = std::make_unique<AudioParameterFloat>(
-        id::PAN, "pan", NormalisableRange<float>{0.f, 1.f, 0.01f, 0.5f}, 0.5f);
-    parameters.pan = parameter.get();
-    layout.add(std::move(parameter));
+    juce::FileOutputStream stream{temporaryFile.getFile()};
+    if (stream.failedToOpen())
+      return juce::Result::fail("Could not write " + file.getFullPathName());
+    preset_bank::write(presets, stream);
   }
+  if (!temporaryFile.overwriteTargetFileWithTemporary())
+    return juce::Result::fail("Could not write " + file.getFullPathName());
+
+  std::unique_ptr<const std::vector<ProgramSnapshot>> newPrograms;
+  if (const auto result = readPresetBank(file, newPrograms); result.failed())
+    return result;
+  swapPrograms(std::move(newPrograms), static_cast<int>(presets.size()) - 1);
+  return juce::Result::ok();
+}
 
-  return layout;
+void AudioPluginAudioProcessor::updateLatency() {
+  setLatencySamples(oversampling.getLatencyInSamples(
+      parameters.oversampling->getIndex(),
+      static_cast<OversamplingStage::FilterType>(
+          parameters.oversamplingFilter->getIndex())));
+}
+
+void AudioPluginAudioProcessor::setHarmonicValues(
+    const juce::Array<float>& newValues,
+    bool isUserEdit) {
+  for (auto i = 0; i < HarmonicTable::MAX_HARMONICS; ++i) {
+    setHarmonicValue(i, i < newValues.size() ? newValues[i] : 0.f, isUserEdit);
+  }
+}
+
+bool AudioPluginAudioProcessor::setHarmonicValue(int index,
+                                                 float value,
+                                                 bool isUserEdit) {
+  if (!juce::isPositiveAndBelow(index, HarmonicTable::MAX_HARMONICS) ||
+      !std::isfinite(value))
+    return false;
+
+  // Unchanged harmonics neither notify the host nor make the audio thread
+  // recompile anything
+  auto& parameter = *parameters.harmonics[static_cast<size_t>(index)];
+  if (const auto normalizedValue = parameter.convertTo0to1(value);
+      !juce::exactlyEqual(normalizedValue, parameter.getValue())) {
+    if (isUserEdit)
+      parameter.beginChangeGesture();
+    parameter.setValueNotifyingHost(normalizedValue);
+    if (isUserEdit)
+      parameter.endChangeGesture();
+  }
+  return true;
 }
 
-void AudioPluginAudioProcessor::setHarmonicValues(const juce::Array<float>& newValues) {
-  const juce::ScopedLock lock(harmonicLock);
-  harmonicValues = newValues;
+float AudioPluginAudioProcessor::getHarmonicValue(int index) const noexcept {
+  if (!juce::isPositiveAndBelow(index, HarmonicTable::MAX_HARMONICS))
+    return 0.f;
+  return parameters.harmonics[static_cast<size_t>(index)]->get();
 }
 
 }  // namespace webview_plugin
@@ -0,0 +1,90 @@
+#include "JuceWebViewTutorial/PresetBank.h"
+#include <algorithm>
+
+namespace webview_plugin::preset_bank {
+void write(const std::vector<Preset>& presets, juce::OutputStream& output) {
+  const auto numPresets =
+      std::min(presets.size(), static_cast<size_t>(MAX_PRESETS));
+
+  std::vector<juce::MemoryBlock> records(numPresets);
+  for (size_t i = 0; i < numPresets; ++i) {
+    juce::MemoryOutputStream record{records[i], false};
+    const auto& name = presets[i].name;
+    const auto nameLength =
+        juce::jmin(static_cast<size_t>(255), name.getNumBytesAsUTF8());
+    record.writeByte(static_cast<char>(nameLength));
+    record.write(name.toRawUTF8(), nameLength);
+    state_format::write(presets[i].state, record);
+  }
+
+  output.write(MAGIC.data(), MAGIC.size());
+  output.writeShort(static_cast<short>(VERSION));
+  output.writeShort(static_cast<short>(numPresets));
+
+  auto offset = HEADER_SIZE + numPresets * INDEX_ENTRY_SIZE;
+  for (const auto& record : records) {
+    output.writeInt(static_cast<int>(offset));
+    output.writeInt(static_cast<int>(record.getSize()));
+    offset += record.getSize();
+  }
+
+  for (const auto& record : records) {
+    output.write(record.getData(), record.getSize());
+  }
+}
+
+juce::Result Reader::open(const juce::File& file) {
+  records.clear();
+  mappedFile = std::make_unique<juce::MemoryMappedFile>(
+      file, juce::MemoryMappedFile::readOnly);
+
+  const auto* data = static_cast<const char*>(mappedFile->getData());
+  const auto size = mappedFile->getSize();
+  if (data == nullptr)
+    return juce::Result::fail("Could not open " + file.getFullPathName());
+  if (size < HEADER_SIZE || !std::equal(MAGIC.begin(), MAGIC.end(), data))
+    return juce::Result::fail("Not a preset bank");
+
+  juce::MemoryInputStream input{data, size, false};
+  input.skipNextBytes(static_cast<juce::int64>(MAGIC.size()));
+  const auto version = static_cast<std::uint16_t>(input.readShort());
+  if (version > VERSION)
+    return juce::Result::fail("The preset bank is from a newer version");
+
+  const auto numPresets =
+      static_cast<size_t>(static_cast<std::uint16_t>(input.readShort()));
+  if (numPresets > static_cast<size_t>(MAX_PRESETS) ||
+      size < HEADER_SIZE + numPresets * INDEX_ENTRY_SIZE)
+    return juce::Result::fail("Truncated preset bank");
+
+  records.reserve(numPresets);
+  for (size_t i = 0; i < numPresets; ++i) {
+    const auto offset = static_cast<std::uint32_t>(input.readInt());
+    const auto recordSize = static_cast<std::uint32_t>(input.readInt());
+    if (offset > size || recordSize > size - offset)
+      return juce::Result::fail("Truncated preset bank");
+
+    records.push_back({.data = data + offset, .size = recordSize});
+  }
+
+  return juce::Result::ok();
+}
+
+juce::Result Reader::read(int index, Preset& preset) const {
+  if (!juce::isPositiveAndBelow(index, getNumPresets()))
+    return juce::Result::fail("No preset " + juce::String{index});
+
+  const auto& record = records[static_cast<size_t>(index)];
+  const auto nameLength =
+      record.size > 0 ? static_cast<size_t>(static_cast<std::uint8_t>(
+                            record.data[0]))
+                      : 0;
+  if (record.size < 1 + nameLength)
+    return juce::Result::fail("Truncated preset");
+
+  preset.name = juce::String::fromUTF8(record.data + 1,
+                                       static_cast<int>(nameLength));
+  return state_format::read(record.data + 1 + nameLength,
+                            record.size - 1 - nameLength, preset.state);
+}
+}  // namespace webview_plugin::preset_bank
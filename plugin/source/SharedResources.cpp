@@ -0,0 +1,33 @@
+#include "JuceWebViewTutorial/SharedResources.h"
+
+#if !WEBVIEW_PLUGIN_HEADLESS
+#include <WebViewFiles.h>
+#endif
+
+namespace webview_plugin {
+SharedResources::SharedResources() {
+#if !WEBVIEW_PLUGIN_HEADLESS
+  // One folder for all WebViews lets WebView2 share a single browser process
+  // between them instead of starting one per editor
+  webViewDataFolder =
+      juce::File::getSpecialLocation(juce::File::tempDirectory)
+          .getChildFile(juce::String{JucePlugin_Name} + " WebView2");
+  webViewDataFolder.createDirectory();
+#endif
+}
+
+SharedResources::~SharedResources() = default;
+
+#if !WEBVIEW_PLUGIN_HEADLESS
+const AssetStore& SharedResources::getAssetStore() const {
+  // Processors never need the web UI files: only the first editor reads the
+  // bundle's manifest
+  std::call_once(assetStoreCreated, [this] {
+    assetStore = std::make_unique<const AssetStore>(
+        webview_files::webview_files_bin,
+        static_cast<size_t>(webview_files::webview_files_binSize));
+  });
+  return *assetStore;
+}
+#endif
+}  // namespace webview_plugin
@@ -0,0 +1,175 @@
+#include "JuceWebViewTutorial/SpectrumAnalyzer.h"
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+
+namespace webview_plugin {
+SpectrumAnalyzer::SpectrumAnalyzer()
+    : juce::Thread{"Spectrum analyzer"}, fifoBuffer(FIFO_CAPACITY) {}
+
+SpectrumAnalyzer::~SpectrumAnalyzer() {
+  stop();
+}
+
+void SpectrumAnalyzer::pushSamples(
+    const juce::dsp::AudioBlock<const float>& block) noexcept {
+  if (!running.load(std::memory_order_acquire) || block.getNumChannels() == 0)
+    return;
+
+  const auto numSamples = static_cast<int>(block.getNumSamples());
+  const auto scope = fifo.write(numSamples);
+  const auto numWritten = scope.blockSize1 + scope.blockSize2;
+
+  if (numWritten < numSamples) {
+    numDroppedSamples.fetch_add(
+        static_cast<std::uint32_t>(numSamples - numWritten),
+        std::memory_order_relaxed);
+  }
+
+  const auto channelGain = 1.f / static_cast<float>(block.getNumChannels());
+  const auto writeMonoSum = [&](int start, int size, int blockOffset) {
+    auto* destination = fifoBuffer.data() + start;
+    juce::FloatVectorOperations::copyWithMultiply(
+        destination, block.getChannelPointer(0) + blockOffset, channelGain,
+        size);
+    for (size_t channel = 1; channel < block.getNumChannels(); ++channel) {
+      juce::FloatVectorOperations::addWithMultiply(
+          destination, block.getChannelPointer(channel) + blockOffset,
+          channelGain, size);
+    }
+  };
+
+  writeMonoSum(scope.startIndex1, scope.blockSize1, 0);
+  writeMonoSum(scope.startIndex2, scope.blockSize2, scope.blockSize1);
+}
+
+void SpectrumAnalyzer::start(const Settings& newSettings) {
+  stop();
+
+  settings = newSettings;
+  settings.fftOrder =
+      juce::jlimit(MIN_FFT_ORDER, MAX_FFT_ORDER, settings.fftOrder);
+  const auto fftSize = 1 << settings.fftOrder;
+  settings.overlap = juce::jlimit(1, fftSize, settings.overlap);
+  settings.releaseSmoothing =
+      juce::jlimit(0.f, 0.999f, settings.releaseSmoothing);
+
+  fft = std::make_unique<juce::dsp::FFT>(settings.fftOrder);
+  window = std::make_unique<juce::dsp::WindowingFunction<float>>(
+      static_cast<size_t>(fftSize),
+      juce::dsp::WindowingFunction<float>::hann, true);
+  history.assign(static_cast<size_t>(fftSize), 0.f);
+  fftData.assign(2 * static_cast<size_t>(fftSize), 0.f);
+  historyPosition = 0;
+  hopSize = fftSize / settings.overlap;
+  samplesUntilNextFrame = hopSize;
+  bandSampleRate = 0.0;
+  smoothedDecibels.fill(MIN_DECIBELS);
+
+  // Stale samples from the previous run. The worker thread isn't running, so
+  // this thread may act as the consumer.
+  fifo.read(fifo.getNumReady());
+
+  running.store(true, std::memory_order_release);
+  startThread(juce::Thread::Priority::low);
+}
+
+void SpectrumAnalyzer::stop() {
+  running.store(false, std::memory_order_release);
+  stopThread(1000);
+}
+
+std::optional<SpectrumAnalyzer::Frame> SpectrumAnalyzer::pullFrame() noexcept {
+  if (!frames.hasNewData())
+    return std::nullopt;
+  return frames.read();
+}
+
+void SpectrumAnalyzer::run() {
+  while (!threadShouldExit()) {
+    if (const auto currentSampleRate =
+            sampleRate.load(std::memory_order_relaxed);
+        !juce::approximatelyEqual(currentSampleRate, bandSampleRate)) {
+      updateBands(currentSampleRate);
+    }
+
+    const auto scope = fifo.read(fifo.getNumReady());
+    scope.forEach([this](int index) {
+      history[historyPosition] = fifoBuffer[static_cast<size_t>(index)];
+      historyPosition = (historyPosition + 1) % history.size();
+
+      if (--samplesUntilNextFrame == 0) {
+        analyze();
+        samplesUntilNextFrame = hopSize;
+      }
+    });
+
+    // The audio thread must not signal: poll instead
+    wait(POLL_INTERVAL_MS);
+  }
+}
+
+void SpectrumAnalyzer::analyze() {
+  WEBVIEW_PROFILE_SCOPE(profilerRing, ProfilerStage::spectrum, hopSize);
+
+  // Oldest sample first
+  const auto fftSize = history.size();
+  const auto split =
+      history.begin() + static_cast<std::ptrdiff_t>(historyPosition);
+  const auto written = std::copy(split, history.end(), fftData.begin());
+  std::copy(history.begin(), split, written);
+  std::fill(fftData.begin() + static_cast<std::ptrdiff_t>(fftSize),
+            fftData.end(), 0.f);
+
+  window->multiplyWithWindowingTable(fftData.data(), fftSize);
+  fft->performFrequencyOnlyForwardTransform(fftData.data(), true);
+
+  // The window is normalized to a sum of fftSize, so a full-scale sine has a
+  // magnitude of fftSize / 2
+  const auto magnitudeToGain = 2.f / static_cast<float>(fftSize);
+  const auto releaseSmoothing = settings.releaseSmoothing;
+  auto& frame = frames.getWriteBuffer();
+
+  for (size_t band = 0; band < NUM_BANDS; ++band) {
+    const auto [firstBin, lastBin] = bandBins[band];
+    const auto magnitude =
+        *std::max_element(fftData.begin() + firstBin,
+                          fftData.begin() + lastBin + 1);
+    const auto decibels = juce::Decibels::gainToDecibels(
+        magnitude * magnitudeToGain, MIN_DECIBELS);
+
+    // Rise immediately, fall smoothly
+    auto& smoothed = smoothedDecibels[band];
+    smoothed = decibels >= smoothed
+                   ? decibels
+                   : decibels + releaseSmoothing * (smoothed - decibels);
+    frame.decibels[band] = smoothed;
+  }
+
+  frames.publish();
+}
+
+void SpectrumAnalyzer::updateBands(double newSampleRate) {
+  bandSampleRate = newSampleRate;
+
+  const auto fftSize = static_cast<double>(history.size());
+  const auto maxBin = static_cast<int>(history.size() / 2);
+  const auto maxFrequency = juce::jmin(MAX_FREQUENCY, newSampleRate / 2.0);
+  const auto toBin = [&](double frequency) {
+    return juce::jlimit(0, maxBin,
+                        static_cast<int>(frequency * fftSize / newSampleRate));
+  };
+
+  for (size_t band = 0; band < NUM_BANDS; ++band) {
+    const auto lowFrequency =
+        MIN_FREQUENCY * std::pow(maxFrequency / MIN_FREQUENCY,
+                                 static_cast<double>(band) / NUM_BANDS);
+    const auto highFrequency =
+        MIN_FREQUENCY * std::pow(maxFrequency / MIN_FREQUENCY,
+                                 static_cast<double>(band + 1) / NUM_BANDS);
+    const auto firstBin = toBin(lowFrequency);
+    // Bands narrower than a bin repeat the bin they lie in
+    bandBins[band] = {firstBin, juce::jmax(firstBin, toBin(highFrequency) - 1)};
+  }
+}
+}  // namespace webview_plugin
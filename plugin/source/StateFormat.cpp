@@ -0,0 +1,130 @@
+#include "JuceWebViewTutorial/StateFormat.h"
+#include <algorithm>
+
+namespace webview_plugin::state_format {
+namespace {
+void writeField(juce::OutputStream& output,
+                Tag tag,
+                const juce::MemoryOutputStream& payload) {
+  output.writeShort(static_cast<short>(tag));
+  output.writeInt(static_cast<int>(payload.getDataSize()));
+  output.write(payload.getData(), payload.getDataSize());
+}
+
+juce::Result readParameters(juce::MemoryInputStream& input,
+                            ProcessorState& state) {
+  const auto count = static_cast<std::uint32_t>(input.readInt());
+  state.parameters.clear();
+  // The count can't be trusted: each parameter takes at least 5 bytes
+  state.parameters.reserve(std::min<size_t>(
+      count, static_cast<size_t>(input.getNumBytesRemaining()) / 5));
+
+  for (auto i = 0u; i < count; ++i) {
+    const auto idLength = static_cast<size_t>(input.readByte()) & 0xff;
+    if (static_cast<size_t>(input.getNumBytesRemaining()) <
+        idLength + sizeof(float))
+      return juce::Result::fail("Truncated parameter");
+
+    const auto* id = static_cast<const char*>(input.getData()) +
+                     input.getPosition();
+    auto parameterId = juce::String::fromUTF8(id, static_cast<int>(idLength));
+    input.skipNextBytes(static_cast<juce::int64>(idLength));
+    state.parameters.emplace_back(std::move(parameterId), input.readFloat());
+  }
+
+  return juce::Result::ok();
+}
+
+void readHarmonics(juce::MemoryInputStream& input, ProcessorState& state) {
+  const auto count = static_cast<std::uint32_t>(input.readInt());
+  state.harmonics.size = static_cast<int>(
+      std::min<std::uint32_t>(count, HarmonicTable::MAX_HARMONICS));
+
+  for (auto i = 0; i < state.harmonics.size; ++i) {
+    state.harmonics.values[static_cast<size_t>(i)] = input.readFloat();
+  }
+}
+}  // namespace
+
+void write(const ProcessorState& state, juce::OutputStream& output) {
+  output.write(MAGIC.data(), MAGIC.size());
+  output.writeShort(static_cast<short>(VERSION));
+
+  juce::MemoryOutputStream payload;
+
+  payload.writeInt(static_cast<int>(state.parameters.size()));
+  for (const auto& [id, value] : state.parameters) {
+    const auto idLength =
+        juce::jmin(static_cast<size_t>(255), id.getNumBytesAsUTF8());
+    payload.writeByte(static_cast<char>(idLength));
+    payload.write(id.toRawUTF8(), idLength);
+    payload.writeFloat(value);
+  }
+  writeField(output, Tag::parameters, payload);
+
+  payload.reset();
+  payload.writeInt(state.harmonics.size);
+  for (auto i = 0; i < state.harmonics.size; ++i) {
+    payload.writeFloat(state.harmonics.values[static_cast<size_t>(i)]);
+  }
+  writeField(output, Tag::harmonics, payload);
+
+  payload.reset();
+  payload.writeInt(state.rootNote);
+  writeField(output, Tag::rootNote, payload);
+
+  payload.reset();
+  payload.writeBool(state.harmonicEnabled);
+  writeField(output, Tag::harmonicEnabled, payload);
+}
+
+juce::Result read(const void* data, size_t sizeInBytes, ProcessorState& state) {
+  constexpr size_t HEADER_SIZE = MAGIC.size() + sizeof(std::uint16_t);
+  constexpr size_t FIELD_HEADER_SIZE =
+      sizeof(std::uint16_t) + sizeof(std::uint32_t);
+
+  if (data == nullptr || sizeInBytes < HEADER_SIZE ||
+      !std::equal(MAGIC.begin(), MAGIC.end(), static_cast<const char*>(data)))
+    return juce::Result::fail("Not a plugin state");
+
+  juce::MemoryInputStream input{data, sizeInBytes, false};
+  input.skipNextBytes(static_cast<juce::int64>(HEADER_SIZE));
+
+  while (static_cast<size_t>(input.getNumBytesRemaining()) >=
+         FIELD_HEADER_SIZE) {
+    const auto tag =
+        static_cast<Tag>(static_cast<std::uint16_t>(input.readShort()));
+    const auto length = static_cast<std::uint32_t>(input.readInt());
+
+    if (static_cast<size_t>(input.getNumBytesRemaining()) < length)
+      return juce::Result::fail("Truncated state");
+
+    // Each field is parsed on its own, so reading can never run past it
+    const auto* payload =
+        static_cast<const char*>(data) + input.getPosition();
+    juce::MemoryInputStream field{payload, length, false};
+    input.skipNextBytes(static_cast<juce::int64>(length));
+
+    switch (tag) {
+      case Tag::parameters:
+        if (const auto result = readParameters(field, state); result.failed())
+          return result;
+        break;
+      case Tag::harmonics:
+        readHarmonics(field, state);
+        break;
+      case Tag::rootNote:
+        state.rootNote = juce::jlimit(0, 127, field.readInt());
+        break;
+      case Tag::harmonicEnabled:
+        state.harmonicEnabled = field.readBool();
+        break;
+      default:
+        // Written by a newer version
+        break;
+    }
+  }
+
+  return juce::Result::ok();
+}
+}  // namespace webview_plugin::state_format
@@ -0,0 +1,98 @@
+#include "JuceWebViewTutorial/TruePeakDetector.h"
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+
+namespace webview_plugin {
+namespace {
+constexpr auto NUM_TAPS =
+    TruePeakDetector::OVERSAMPLING_FACTOR * TruePeakDetector::TAPS_PER_PHASE;
+constexpr auto HISTORY_SIZE = TruePeakDetector::TAPS_PER_PHASE - 1;
+}  // namespace
+
+TruePeakDetector::TruePeakDetector() {
+  // Hann-windowed sinc with its cutoff at the original Nyquist frequency,
+  // centred on a tap of phase 0. That phase then passes the input samples
+  // through, so the true peak never reads below the sample peak; the other
+  // phases interpolate at a quarter, half and three quarters of a sample.
+  // The window ends at zero on both sides, so the tap after the last one
+  // would be zero: this is the odd-length filter with that tap left out.
+  constexpr auto centre = NUM_TAPS / 2;
+
+  for (auto phase = 0; phase < OVERSAMPLING_FACTOR; ++phase) {
+    auto& coefficients = phases[static_cast<size_t>(phase)];
+    auto sum = 0.0;
+
+    for (auto tap = 0; tap < TAPS_PER_PHASE; ++tap) {
+      const auto index = tap * OVERSAMPLING_FACTOR + phase;
+      const auto x =
+          static_cast<double>(index - centre) / OVERSAMPLING_FACTOR;
+      // Exact zeros at the other input samples
+      const auto isSampleAligned = (index - centre) % OVERSAMPLING_FACTOR == 0;
+      const auto sinc =
+          isSampleAligned ? (index == centre ? 1.0 : 0.0)
+                          : std::sin(juce::MathConstants<double>::pi * x) /
+                                (juce::MathConstants<double>::pi * x);
+      const auto window =
+          0.5 + 0.5 * std::cos(juce::MathConstants<double>::pi *
+                               (index - centre) / centre);
+      coefficients[static_cast<size_t>(TAPS_PER_PHASE - 1 - tap)] =
+          static_cast<float>(sinc * window);
+      sum += sinc * window;
+    }
+
+    // Unity gain at DC in every phase, so that no phase reads high. Phase 0
+    // has a single non-zero tap of 1 already.
+    for (auto& coefficient : coefficients) {
+      coefficient = static_cast<float>(coefficient / sum);
+    }
+  }
+}
+
+void TruePeakDetector::prepare(int numChannelsToProcess, int maxBlockSize) {
+  numChannels = juce::jmax(0, numChannelsToProcess);
+  history.assign(static_cast<size_t>(numChannels * HISTORY_SIZE), 0.f);
+  scratch.assign(static_cast<size_t>(HISTORY_SIZE + juce::jmax(1, maxBlockSize)),
+                 0.f);
+}
+
+void TruePeakDetector::reset() noexcept {
+  std::fill(history.begin(), history.end(), 0.f);
+}
+
+float TruePeakDetector::process(int channel,
+                                const float* samples,
+                                size_t numSamples) noexcept {
+  if (!juce::isPositiveAndBelow(channel, numChannels))
+    return 0.f;
+
+  auto* channelHistory =
+      history.data() + static_cast<size_t>(channel * HISTORY_SIZE);
+  const auto maxChunkSize = scratch.size() - HISTORY_SIZE;
+  auto peak = 0.f;
+
+  for (size_t start = 0; start < numSamples; start += maxChunkSize) {
+    const auto chunkSize = std::min(maxChunkSize, numSamples - start);
+
+    // History and chunk back to back, so every output is one dot product
+    std::copy_n(channelHistory, HISTORY_SIZE, scratch.begin());
+    std::copy_n(samples + start, chunkSize, scratch.begin() + HISTORY_SIZE);
+
+    for (const auto& coefficients : phases) {
+      for (size_t i = 0; i < chunkSize; ++i) {
+        const auto* input = scratch.data() + i;
+        auto sum = 0.f;
+        for (auto tap = 0u; tap < coefficients.size(); ++tap) {
+          sum += input[tap] * coefficients[tap];
+        }
+        peak = std::max(peak, std::abs(sum));
+      }
+    }
+
+    std::copy_n(scratch.begin() + static_cast<std::ptrdiff_t>(chunkSize),
+                HISTORY_SIZE, channelHistory);
+  }
+
+  return peak;
+}
+}  // namespace webview_plugin
@@ -0,0 +1,28 @@
+#include "JuceWebViewTutorial/Waveshaper.h"
+#include <cmath>
+
+namespace webview_plugin {
+LookupTableTanh::LookupTableTanh() : table(TABLE_SIZE + 1) {
+  for (auto i = 0u; i < table.size(); ++i) {
+    const auto x = -INPUT_LIMIT + 2.f * INPUT_LIMIT * static_cast<float>(i) /
+                                      static_cast<float>(TABLE_SIZE);
+    table[i] = std::tanh(x);
+  }
+}
+
+void Waveshaper::process(juce::dsp::AudioBlock<float> block,
+                         ShaperType type) const noexcept {
+  if (type == ShaperType::none)
+    return;
+
+  if (type == ShaperType::chebyshev) {
+    for (auto channel = 0u; channel < block.getNumChannels(); ++channel) {
+      polynomial->process(block.getChannelPointer(channel),
+                          block.getNumSamples());
+    }
+    return;
+  }
+
+  visit(type, [block](const auto& shape) { processWith(block, shape); });
+}
+}  // namespace webview_plugin
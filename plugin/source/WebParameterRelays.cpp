@@ -0,0 +1,56 @@
+#include "JuceWebViewTutorial/WebParameterRelays.h"
+#include "JuceWebViewTutorial/ParameterRegistry.h"
+
+namespace webview_plugin {
+WebParameterRelays::WebParameterRelays(
+    juce::AudioProcessorValueTreeState& state) {
+  for (const auto& spec : getParameterSpecs()) {
+    if (!spec.hasWebRelay)
+      continue;
+
+    const auto& parameterId = spec.id.getParamID();
+    auto& parameter = *state.getParameter(parameterId);
+
+    switch (spec.type) {
+      case ParameterSpec::Type::continuous: {
+        auto& relay = *sliderRelays.emplace_back(
+            std::make_unique<juce::WebSliderRelay>(parameterId));
+        sliderAttachments.push_back(
+            std::make_unique<juce::WebSliderParameterAttachment>(
+                parameter, relay, nullptr));
+        break;
+      }
+      case ParameterSpec::Type::toggle: {
+        auto& relay = *toggleRelays.emplace_back(
+            std::make_unique<juce::WebToggleButtonRelay>(parameterId));
+        toggleAttachments.push_back(
+            std::make_unique<juce::WebToggleButtonParameterAttachment>(
+                parameter, relay, nullptr));
+        break;
+      }
+      case ParameterSpec::Type::choice: {
+        auto& relay = *comboBoxRelays.emplace_back(
+            std::make_unique<juce::WebComboBoxRelay>(parameterId));
+        comboBoxAttachments.push_back(
+            std::make_unique<juce::WebComboBoxParameterAttachment>(
+                parameter, relay, nullptr));
+        break;
+      }
+    }
+  }
+}
+
+juce::WebBrowserComponent::Options WebParameterRelays::addTo(
+    juce::WebBrowserComponent::Options options) {
+  for (const auto& relay : sliderRelays) {
+    options = options.withOptionsFrom(*relay);
+  }
+  for (const auto& relay : toggleRelays) {
+    options = options.withOptionsFrom(*relay);
+  }
+  for (const auto& relay : comboBoxRelays) {
+    options = options.withOptionsFrom(*relay);
+  }
+  return options;
+}
+}  // namespace webview_plugin
@@ -0,0 +1,221 @@
+#include "JuceWebViewTutorial/HarmonicMidiGenerator.h"
+#include "JuceWebViewTutorial/ParameterIDs.hpp"
+#include "JuceWebViewTutorial/PluginProcessor.h"
+#include <juce_core/juce_core.h>
+#include "HeapCallCounter.h"
+#include "ProcessorTestUtils.h"
+#include <algorithm>
+#include <array>
+#include <vector>
+
+namespace webview_plugin::test {
+namespace {
+constexpr auto SAMPLE_RATE = 48000.0;
+constexpr auto BLOCK_SIZE = 256;
+constexpr auto NUM_HARMONICS = 8;
+// The replay ends in block 4, the rest checks that nothing is left over
+constexpr auto NUM_BLOCKS = 6;
+// A chord whose harmonics need far more storage than its note-ons
+constexpr auto CHORD_SIZE = 16;
+
+struct ReplayEvent {
+  int block = 0;
+  int samplePosition = 0;
+  juce::MidiMessage message;
+};
+
+// Notes are retriggered while held, the second harmonic of 48 is the held
+// root 60, and channel 2 plays a note that channel 1 plays too
+std::vector<ReplayEvent> createReplay() {
+  using juce::MidiMessage;
+  constexpr auto VELOCITY = juce::uint8{100};
+
+  return {
+      {0, 0, MidiMessage::noteOn(1, 60, VELOCITY)},
+      {0, 10, MidiMessage::noteOn(1, 48, VELOCITY)},
+      {0, 100, MidiMessage::noteOn(1, 60, VELOCITY)},
+      {1, 5, MidiMessage::noteOff(1, 48)},
+      {1, 50, MidiMessage::noteOn(1, 64, VELOCITY)},
+      {1, 50, MidiMessage::noteOn(2, 60, VELOCITY)},
+      {1, 51, MidiMessage::noteOn(1, 64, VELOCITY)},
+      {2, 0, MidiMessage::noteOff(1, 60)},
+      {2, 200, MidiMessage::noteOn(1, 60, VELOCITY)},
+      {3, 3, MidiMessage::noteOff(1, 60)},
+      {3, 128, MidiMessage::noteOff(1, 64)},
+      {3, 128, MidiMessage::noteOff(2, 60)},
+      {4, 0, MidiMessage::noteOn(1, 36, VELOCITY)},
+      {4, 1, MidiMessage::noteOff(1, 36)},
+  };
+}
+
+void fillBlock(juce::MidiBuffer& midi,
+               const std::vector<ReplayEvent>& replay,
+               int block) {
+  midi.clear();
+  for (const auto& event : replay) {
+    if (event.block == block)
+      midi.addEvent(event.message, event.samplePosition);
+  }
+}
+
+// What a synth receiving the output keeps track of: whether a note sounds,
+// regardless of how often it was started
+class NoteReceiver {
+public:
+  void receive(const juce::MidiBuffer& midi) {
+    for (const auto metadata : midi) {
+      const auto message = metadata.getMessage();
+      if (message.isNoteOn())
+        setSounding(message, true);
+      else if (message.isNoteOff())
+        setSounding(message, false);
+    }
+  }
+
+  [[nodiscard]] int getNumSoundingNotes() const {
+    return static_cast<int>(std::count(sounding.begin(), sounding.end(), true));
+  }
+
+private:
+  void setSounding(const juce::MidiMessage& message, bool isSounding) {
+    const auto index =
+        (message.getChannel() - 1) * ActiveNoteTracker::NUM_NOTES +
+        message.getNoteNumber();
+    sounding[static_cast<size_t>(index)] = isSounding;
+  }
+
+  std::array<bool, static_cast<size_t>(ActiveNoteTracker::NUM_CHANNELS *
+                                       ActiveNoteTracker::NUM_NOTES)>
+      sounding{};
+};
+
+class HarmonicMidiTest final : public juce::UnitTest {
+public:
+  HarmonicMidiTest() : juce::UnitTest{"Harmonic MIDI", "WebViewPlugin"} {}
+
+  void runTest() override {
+    const auto replay = createReplay();
+
+    beginTest("The generator releases every note it starts");
+    {
+      HarmonicTable table{.size = NUM_HARMONICS};
+      const auto values = createHarmonicValues(NUM_HARMONICS);
+      std::copy(values.begin(), values.end(), table.values.begin());
+      const auto plan = VoicingPlan::compile(table);
+
+      HarmonicMidiGenerator generator;
+      generator.prepare();
+      juce::MidiBuffer midi;
+      NoteReceiver receiver;
+
+      for (auto block = 0; block < NUM_BLOCKS; ++block) {
+        fillBlock(midi, replay, block);
+        expectEquals(
+            countHeapCalls([&] { generator.process(midi, plan); }), 0,
+            "Block " + juce::String{block} + " used the heap");
+        receiver.receive(midi);
+      }
+
+      expectEquals(receiver.getNumSoundingNotes(), 0, "Hanging notes");
+      expectEquals(generator.getActiveNotes().getNumSoundingNotes(), 0,
+                   "Notes left in the tracker");
+      expectEquals(static_cast<int>(generator.getNumCapacityOverflows()), 0);
+    }
+
+    beginTest("The generator fills a default-sized host buffer without allocating");
+    {
+      HarmonicTable table{.size = NUM_HARMONICS};
+      const auto values = createHarmonicValues(NUM_HARMONICS);
+      std::copy(values.begin(), values.end(), table.values.begin());
+      const auto plan = VoicingPlan::compile(table);
+
+      HarmonicMidiGenerator generator;
+      generator.prepare();
+      // Reused every block, as hosts do, but never sized for the output
+      juce::MidiBuffer midi;
+
+      for (auto block = 0; block < NUM_BLOCKS; ++block) {
+        midi.clear();
+        for (auto note = 0; note < CHORD_SIZE; ++note) {
+          midi.addEvent(block % 2 == 0
+                            ? juce::MidiMessage::noteOn(1, 36 + note,
+                                                        juce::uint8{100})
+                            : juce::MidiMessage::noteOff(1, 36 + note),
+                        note);
+        }
+        expectEquals(
+            countHeapCalls([&] { generator.process(midi, plan); }), 0,
+            "Block " + juce::String{block} + " used the heap");
+        expectGreaterThan(midi.getNumEvents(), CHORD_SIZE);
+      }
+
+      expectEquals(static_cast<int>(generator.getNumCapacityOverflows()), 0);
+    }
+
+    beginTest("The processor replays MIDI without hanging notes or allocating");
+    {
+      AudioPluginAudioProcessor processor;
+      processor.setHarmonicValues(createHarmonicValues(NUM_HARMONICS));
+      prepare(processor, SAMPLE_RATE, BLOCK_SIZE);
+
+      juce::AudioBuffer<float> buffer{processor.getTotalNumOutputChannels(),
+                                      BLOCK_SIZE};
+      juce::MidiBuffer midi;
+      NoteReceiver receiver;
+
+      for (auto block = 0; block < NUM_BLOCKS; ++block) {
+        buffer.clear();
+        fillBlock(midi, replay, block);
+        expectEquals(
+            countHeapCalls([&] { processor.processBlock(buffer, midi); }), 0,
+            "Block " + juce::String{block} + " used the heap");
+        receiver.receive(midi);
+      }
+
+      expectEquals(receiver.getNumSoundingNotes(), 0, "Hanging notes");
+      expectEquals(static_cast<int>(processor.getNumMidiCapacityOverflows()),
+                   0);
+    }
+
+    beginTest("Leaving the MIDI engine releases the harmonics of held notes");
+    {
+      AudioPluginAudioProcessor processor;
+      processor.setHarmonicValues(createHarmonicValues(NUM_HARMONICS));
+      prepare(processor, SAMPLE_RATE, BLOCK_SIZE);
+
+      juce::AudioBuffer<float> buffer{processor.getTotalNumOutputChannels(),
+                                      BLOCK_SIZE};
+      juce::MidiBuffer midi;
+      NoteReceiver receiver;
+
+      const auto process = [&] {
+        buffer.clear();
+        expectEquals(
+            countHeapCalls([&] { processor.processBlock(buffer, midi); }), 0);
+        receiver.receive(midi);
+      };
+
+      midi.clear();
+      midi.addEvent(juce::MidiMessage::noteOn(1, 48, juce::uint8{100}), 0);
+      midi.addEvent(juce::MidiMessage::noteOn(1, 60, juce::uint8{100}), 0);
+      process();
+      expectGreaterThan(receiver.getNumSoundingNotes(), 2);
+
+      // The held roots keep sounding, their harmonics stop
+      setParameter(processor, id::HARMONIC_ENGINE, 1.f);
+      midi.clear();
+      process();
+      expectEquals(receiver.getNumSoundingNotes(), 2);
+
+      midi.clear();
+      midi.addEvent(juce::MidiMessage::noteOff(1, 48), 0);
+      midi.addEvent(juce::MidiMessage::noteOff(1, 60), 0);
+      process();
+      expectEquals(receiver.getNumSoundingNotes(), 0, "Hanging notes");
+    }
+  }
+};
+
+HarmonicMidiTest harmonicMidiTest;
+}  // namespace
+}  // namespace webview_plugin::test
@@ -0,0 +1,131 @@
+#include "JuceWebViewTutorial/ParameterIDs.hpp"
+#include "JuceWebViewTutorial/PluginProcessor.h"
+#include <juce_core/juce_core.h>
+#include "HeapCallCounter.h"
+#include "ProcessorTestUtils.h"
+#include <atomic>
+#include <cmath>
+#include <thread>
+
+namespace webview_plugin::test {
+namespace {
+constexpr auto SAMPLE_RATE = 48000.0;
+constexpr auto BLOCK_SIZE = 64;
+// About 5 seconds of audio
+constexpr auto NUM_BLOCKS = 4000;
+// A note starts every NOTE_PERIOD_BLOCKS and is held for half of that
+constexpr auto NOTE_PERIOD_BLOCKS = 16;
+// A block that takes longer than its duration is an xrun. CI machines are
+// shared and may run debug builds: only blocks this many times over count.
+constexpr auto DEADLINE_MARGIN = 4.0;
+
+void fillBlock(juce::AudioBuffer<float>& buffer,
+               juce::MidiBuffer& midi,
+               juce::Random& random,
+               int block) {
+  for (auto channel = 0; channel < buffer.getNumChannels(); ++channel) {
+    for (auto i = 0; i < buffer.getNumSamples(); ++i) {
+      buffer.setSample(channel, i, 0.5f * (2.f * random.nextFloat() - 1.f));
+    }
+  }
+
+  midi.clear();
+  const auto note = 48 + (block / NOTE_PERIOD_BLOCKS) % 24;
+  if (block % NOTE_PERIOD_BLOCKS == 0)
+    midi.addEvent(juce::MidiMessage::noteOn(1, note, juce::uint8{100}), 0);
+  else if (block % NOTE_PERIOD_BLOCKS == NOTE_PERIOD_BLOCKS / 2)
+    midi.addEvent(juce::MidiMessage::noteOff(1, note), BLOCK_SIZE / 2);
+}
+
+[[nodiscard]] bool isFinite(const juce::AudioBuffer<float>& buffer) {
+  for (auto channel = 0; channel < buffer.getNumChannels(); ++channel) {
+    for (auto i = 0; i < buffer.getNumSamples(); ++i) {
+      if (!std::isfinite(buffer.getSample(channel, i)))
+        return false;
+    }
+  }
+  return true;
+}
+
+class HarmonicUpdateStressTest final : public juce::UnitTest {
+public:
+  HarmonicUpdateStressTest()
+      : juce::UnitTest{"Harmonic update stress", "WebViewPlugin"} {}
+
+  void runTest() override {
+    beginTest("Rendering while the UI edits harmonics never touches the heap "
+              "or misses a deadline");
+
+    AudioPluginAudioProcessor processor;
+    processor.setHarmonicValues(
+        createHarmonicValues(HarmonicTable::MAX_HARMONICS));
+    prepare(processor, SAMPLE_RATE, BLOCK_SIZE);
+
+    // Stands in for the message thread while the user drags across the
+    // harmonic editor and automates the other parameters
+    std::atomic<bool> isRendering{true};
+    std::atomic<int> numUpdates{0};
+    std::thread updater{[&] {
+      juce::Random random{42};
+      while (isRendering.load(std::memory_order_relaxed)) {
+        for (auto i = 0; i < HarmonicTable::MAX_HARMONICS; ++i) {
+          processor.setHarmonicValue(i, 100.f * random.nextFloat());
+        }
+        setParameter(processor, id::GAIN, random.nextFloat());
+        setParameter(processor, id::PAN, random.nextFloat());
+        setParameter(processor, id::DISTORTION_TYPE,
+                     static_cast<float>(random.nextInt(3)));
+        setParameter(processor, id::HARMONIC_EXCITER,
+                     random.nextBool() ? 1.f : 0.f);
+        setParameter(processor, id::HARMONIC_ENGINE,
+                     static_cast<float>(random.nextInt(2)));
+        numUpdates.fetch_add(1, std::memory_order_relaxed);
+      }
+    }};
+
+    // Renders only once the updates are underway
+    while (numUpdates.load(std::memory_order_relaxed) == 0)
+      std::this_thread::yield();
+
+    juce::AudioBuffer<float> buffer{processor.getTotalNumOutputChannels(),
+                                    BLOCK_SIZE};
+    juce::MidiBuffer midi;
+    juce::Random random{7};
+    auto numHeapCalls = 0;
+    auto numNonFiniteBlocks = 0;
+    auto numLateBlocks = 0;
+    auto maxBlockSeconds = 0.0;
+    constexpr auto BLOCK_DEADLINE_SECONDS =
+        DEADLINE_MARGIN * BLOCK_SIZE / SAMPLE_RATE;
+
+    for (auto block = 0; block < NUM_BLOCKS; ++block) {
+      fillBlock(buffer, midi, random, block);
+      const auto start = juce::Time::getHighResolutionTicks();
+      numHeapCalls +=
+          countHeapCalls([&] { processor.processBlock(buffer, midi); });
+      const auto blockSeconds = juce::Time::highResolutionTicksToSeconds(
+          juce::Time::getHighResolutionTicks() - start);
+      maxBlockSeconds = juce::jmax(maxBlockSeconds, blockSeconds);
+      if (blockSeconds > BLOCK_DEADLINE_SECONDS)
+        ++numLateBlocks;
+      if (!isFinite(buffer))
+        ++numNonFiniteBlocks;
+    }
+
+    isRendering.store(false, std::memory_order_relaxed);
+    updater.join();
+
+    logMessage(juce::String{numUpdates.load()} + " updates during " +
+               juce::String{NUM_BLOCKS} + " blocks, the longest taking " +
+               juce::String{1000.0 * maxBlockSeconds, 3} + " ms");
+    expectEquals(numHeapCalls, 0, "Heap calls on the audio thread");
+    expectEquals(numNonFiniteBlocks, 0, "Blocks with NaN or inf samples");
+    expectEquals(numLateBlocks, 0,
+                 "Blocks over " + juce::String{DEADLINE_MARGIN} +
+                     " times their duration");
+  }
+};
+
+HarmonicUpdateStressTest harmonicUpdateStressTest;
+}  // namespace
+}  // namespace webview_plugin::test
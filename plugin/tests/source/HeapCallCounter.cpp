@@ -0,0 +1,121 @@
+#include "HeapCallCounter.h"
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+#if defined(__GLIBC__)
+// The implementations behind glibc's malloc and free, called by the
+// replacements below
+extern "C" {
+void* __libc_malloc(std::size_t size) noexcept;
+void* __libc_calloc(std::size_t count, std::size_t size) noexcept;
+void* __libc_realloc(void* pointer, std::size_t size) noexcept;
+void __libc_free(void* pointer) noexcept;
+}
+#endif
+
+namespace webview_plugin::test {
+namespace {
+// Constant-initialized, so reading them never allocates
+thread_local bool isCounting = false;
+thread_local int numHeapCalls = 0;
+
+void countHeapCall() noexcept {
+  if (isCounting)
+    ++numHeapCalls;
+}
+
+void* allocate(std::size_t size) noexcept {
+#if defined(__GLIBC__)
+  return __libc_malloc(size);
+#else
+  return std::malloc(size);
+#endif
+}
+
+void deallocate(void* pointer) noexcept {
+#if defined(__GLIBC__)
+  __libc_free(pointer);
+#else
+  std::free(pointer);
+#endif
+}
+
+void* allocateOrThrow(std::size_t size) {
+  countHeapCall();
+  if (auto* pointer = allocate(size == 0 ? 1 : size))
+    return pointer;
+  throw std::bad_alloc{};
+}
+
+void deallocateCounted(void* pointer) noexcept {
+  if (pointer == nullptr)
+    return;
+  countHeapCall();
+  deallocate(pointer);
+}
+}  // namespace
+
+ScopedHeapCallCounter::ScopedHeapCallCounter() noexcept {
+  numHeapCalls = 0;
+  isCounting = true;
+}
+
+ScopedHeapCallCounter::~ScopedHeapCallCounter() noexcept {
+  isCounting = false;
+}
+
+int ScopedHeapCallCounter::getNumHeapCalls() const noexcept {
+  return numHeapCalls;
+}
+}  // namespace webview_plugin::test
+
+void* operator new(std::size_t size) {
+  return webview_plugin::test::allocateOrThrow(size);
+}
+
+void* operator new[](std::size_t size) {
+  return webview_plugin::test::allocateOrThrow(size);
+}
+
+void operator delete(void* pointer) noexcept {
+  webview_plugin::test::deallocateCounted(pointer);
+}
+
+void operator delete[](void* pointer) noexcept {
+  webview_plugin::test::deallocateCounted(pointer);
+}
+
+void operator delete(void* pointer, std::size_t) noexcept {
+  webview_plugin::test::deallocateCounted(pointer);
+}
+
+void operator delete[](void* pointer, std::size_t) noexcept {
+  webview_plugin::test::deallocateCounted(pointer);
+}
+
+#if defined(__GLIBC__)
+extern "C" {
+void* malloc(std::size_t size) noexcept {
+  webview_plugin::test::countHeapCall();
+  return __libc_malloc(size);
+}
+
+void* calloc(std::size_t count, std::size_t size) noexcept {
+  webview_plugin::test::countHeapCall();
+  return __libc_calloc(count, size);
+}
+
+void* realloc(void* pointer, std::size_t size) noexcept {
+  webview_plugin::test::countHeapCall();
+  return __libc_realloc(pointer, size);
+}
+
+void free(void* pointer) noexcept {
+  if (pointer == nullptr)
+    return;
+  webview_plugin::test::countHeapCall();
+  __libc_free(pointer);
+}
+}
+#endif
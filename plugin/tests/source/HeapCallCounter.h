@@ -0,0 +1,32 @@
+#pragma once
+
+namespace webview_plugin::test {
+
+/**
+ * @brief Counts the heap calls the current thread makes while in scope.
+ *
+ * This binary replaces the global operator new and delete and, with glibc,
+ * also malloc, calloc, realloc and free, which JUCE's containers use. Other
+ * threads are not counted, so they may allocate freely while the audio
+ * thread is checked.
+ */
+class ScopedHeapCallCounter {
+public:
+  ScopedHeapCallCounter() noexcept;
+  ~ScopedHeapCallCounter() noexcept;
+
+  ScopedHeapCallCounter(const ScopedHeapCallCounter&) = delete;
+  ScopedHeapCallCounter& operator=(const ScopedHeapCallCounter&) = delete;
+
+  /** Allocations and deallocations since construction. */
+  [[nodiscard]] int getNumHeapCalls() const noexcept;
+};
+
+/** Heap calls the current thread makes while calling function. */
+template <typename Function>
+[[nodiscard]] int countHeapCalls(Function&& function) {
+  const ScopedHeapCallCounter counter;
+  function();
+  return counter.getNumHeapCalls();
+}
+}  // namespace webview_plugin::test
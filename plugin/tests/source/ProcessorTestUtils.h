@@ -0,0 +1,33 @@
+#pragma once
+
+#include <juce_audio_processors/juce_audio_processors.h>
+#include "JuceWebViewTutorial/PluginProcessor.h"
+#include <cmath>
+
+namespace webview_plugin::test {
+inline void setParameter(AudioPluginAudioProcessor& processor,
+                         const juce::ParameterID& parameterId,
+                         float value) {
+  auto* parameter = processor.getState().getParameter(parameterId.getParamID());
+  jassert(parameter != nullptr);
+  parameter->setValueNotifyingHost(parameter->convertTo0to1(value));
+}
+
+// Same fall-off as the web UI's default harmonic amplitudes
+inline juce::Array<float> createHarmonicValues(int numHarmonics) {
+  juce::Array<float> values;
+  for (auto i = 0; i < numHarmonics; ++i) {
+    values.add(juce::jmax(
+        5.f, std::floor(80.f * std::pow(0.75f, static_cast<float>(i)))));
+  }
+  return values;
+}
+
+// Prepares the processor the way a host does before rendering
+inline void prepare(AudioPluginAudioProcessor& processor,
+                    double sampleRate,
+                    int blockSize) {
+  processor.setRateAndBufferSizeDetails(sampleRate, blockSize);
+  processor.prepareToPlay(sampleRate, blockSize);
+}
+}  // namespace webview_plugin::test
@@ -0,0 +1,163 @@
+#include "JuceWebViewTutorial/ParameterIDs.hpp"
+#include "JuceWebViewTutorial/PluginProcessor.h"
+#include "JuceWebViewTutorial/StateFormat.h"
+#include <juce_core/juce_core.h>
+#include "ProcessorTestUtils.h"
+#include <utility>
+
+namespace webview_plugin::test {
+namespace {
+constexpr auto NUM_INSTANCES = 20;
+
+bool isSameState(const ProcessorState& lhs, const ProcessorState& rhs) {
+  return lhs.parameters == rhs.parameters &&
+         lhs.harmonics.size == rhs.harmonics.size &&
+         lhs.harmonics.values == rhs.harmonics.values &&
+         lhs.rootNote == rhs.rootNote &&
+         lhs.harmonicEnabled == rhs.harmonicEnabled;
+}
+
+// Gives the processor a state that differs from the defaults everywhere
+void randomize(AudioPluginAudioProcessor& processor, juce::Random& random) {
+  setParameter(processor, id::GAIN, random.nextFloat());
+  setParameter(processor, id::PAN, random.nextFloat());
+  setParameter(processor, id::BYPASS, random.nextBool() ? 1.f : 0.f);
+  setParameter(processor, id::DISTORTION_TYPE,
+               static_cast<float>(random.nextInt(3)));
+  setParameter(processor, id::HARMONIC_EXCITER, random.nextBool() ? 1.f : 0.f);
+  setParameter(processor, id::OVERSAMPLING,
+               static_cast<float>(random.nextInt(4)));
+  setParameter(processor, id::HARMONIC_ENGINE,
+               static_cast<float>(random.nextInt(2)));
+
+  juce::Array<float> harmonics;
+  for (auto i = 0; i < HarmonicTable::MAX_HARMONICS; ++i) {
+    harmonics.add(static_cast<float>(5 * random.nextInt(21)));
+  }
+  processor.setHarmonicValues(harmonics);
+  processor.setRootNote(36 + random.nextInt(48));
+  processor.setHarmonicEnabled(random.nextBool());
+}
+
+void writeHeader(juce::OutputStream& output) {
+  output.write(state_format::MAGIC.data(), state_format::MAGIC.size());
+  output.writeShort(static_cast<short>(state_format::VERSION));
+}
+
+void writeField(juce::OutputStream& output,
+                std::uint16_t tag,
+                const juce::MemoryBlock& payload) {
+  output.writeShort(static_cast<short>(tag));
+  output.writeInt(static_cast<int>(payload.getSize()));
+  output.write(payload.getData(), payload.getSize());
+}
+
+class StateFormatTest final : public juce::UnitTest {
+public:
+  StateFormatTest() : juce::UnitTest{"Plugin state", "WebViewPlugin"} {}
+
+  void runTest() override {
+    juce::Random random{42};
+
+    beginTest("States round-trip between instances");
+    for (auto i = 0; i < NUM_INSTANCES; ++i) {
+      AudioPluginAudioProcessor source;
+      randomize(source, random);
+      juce::MemoryBlock data;
+      source.getStateInformation(data);
+
+      AudioPluginAudioProcessor destination;
+      destination.setStateInformation(data.getData(),
+                                      static_cast<int>(data.getSize()));
+      expect(isSameState(destination.captureState(), source.captureState()),
+             "Instance " + juce::String{i} + " lost its state");
+    }
+
+    beginTest("Saved automation selects the same distortion types");
+    {
+      AudioPluginAudioProcessor processor;
+      auto& distortionType = *processor.getState().getParameter(
+          id::DISTORTION_TYPE.getParamID());
+      // The normalized values of none, tanh(kx)/tanh(k) and sigmoid
+      for (const auto [normalizedValue, index] :
+           {std::pair{0.f, 0}, std::pair{0.5f, 1}, std::pair{1.f, 2}}) {
+        distortionType.setValueNotifyingHost(normalizedValue);
+        expectEquals(processor.getDistortionTypeParameter().getIndex(), index);
+      }
+    }
+
+    beginTest("Fields of newer versions are skipped");
+    {
+      AudioPluginAudioProcessor processor;
+      randomize(processor, random);
+      const auto expected = processor.captureState();
+
+      juce::MemoryBlock data;
+      {
+        juce::MemoryOutputStream output{data, false};
+        state_format::write(expected, output);
+        writeField(output, 0x7fff, juce::MemoryBlock{13, true});
+      }
+
+      auto state = ProcessorState{};
+      expect(state_format::read(data.getData(), data.getSize(), state)
+                 .wasOk());
+      expect(isSameState(state, expected));
+    }
+
+    beginTest("Fields missing from older versions keep their values");
+    {
+      juce::MemoryBlock data;
+      {
+        juce::MemoryOutputStream output{data, false};
+        writeHeader(output);
+        juce::MemoryBlock rootNote;
+        juce::MemoryOutputStream{rootNote, false}.writeInt(72);
+        writeField(output,
+                   static_cast<std::uint16_t>(state_format::Tag::rootNote),
+                   rootNote);
+      }
+
+      AudioPluginAudioProcessor processor;
+      randomize(processor, random);
+      auto expected = processor.captureState();
+      expected.rootNote = 72;
+
+      processor.setStateInformation(data.getData(),
+                                    static_cast<int>(data.getSize()));
+      expect(isSameState(processor.captureState(), expected));
+    }
+
+    beginTest("Corrupt states change nothing");
+    {
+      AudioPluginAudioProcessor source;
+      randomize(source, random);
+      juce::MemoryBlock data;
+      source.getStateInformation(data);
+
+      AudioPluginAudioProcessor processor;
+      randomize(processor, random);
+      const auto expected = processor.captureState();
+
+      // Cut anywhere inside the first field, the parameters. Cuts between
+      // fields leave a valid state with fields missing.
+      constexpr auto FIRST_PAYLOAD_OFFSET = 12;
+      const auto parametersLength =
+          static_cast<int>(juce::ByteOrder::littleEndianInt(
+              static_cast<const char*>(data.getData()) + 8));
+      for (auto size = FIRST_PAYLOAD_OFFSET;
+           size < FIRST_PAYLOAD_OFFSET + parametersLength; ++size) {
+        processor.setStateInformation(data.getData(), size);
+      }
+      expect(isSameState(processor.captureState(), expected));
+
+      const auto* text = "not a state";
+      processor.setStateInformation(text, 11);
+      expect(isSameState(processor.captureState(), expected));
+    }
+  }
+};
+
+StateFormatTest stateFormatTest;
+}  // namespace
+}  // namespace webview_plugin::test
@@ -0,0 +1,179 @@
+#include "JuceWebViewTutorial/ParameterIDs.hpp"
+#include "JuceWebViewTutorial/PluginProcessor.h"
+#include "JuceWebViewTutorial/SubBlockScheduler.h"
+#include <juce_core/juce_core.h>
+#include "ProcessorTestUtils.h"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <vector>
+
+namespace webview_plugin::test {
+namespace {
+constexpr auto SAMPLE_RATE = 48000.0;
+constexpr auto NUM_BLOCKS = 64;
+constexpr std::array BLOCK_SIZES{64, 512, 2048};
+constexpr std::array SUB_BLOCK_SIZES{16, 32, 64, 128};
+// Rounding is all that may differ between sub-blocks and whole blocks
+constexpr auto MAX_SUB_BLOCK_DIFFERENCE = 1e-6f;
+
+// Renders a sine with gain and pan changing every few blocks and a note
+// pattern in the MIDI
+juce::AudioBuffer<float> renderWithAutomation(int blockSize,
+                                              int maxSubBlockSize) {
+  AudioPluginAudioProcessor processor;
+  setParameter(processor, id::DISTORTION_TYPE, 1.f);
+  setParameter(processor, id::OVERSAMPLING, 1.f);
+  processor.setMaxSubBlockSize(maxSubBlockSize);
+  prepare(processor, SAMPLE_RATE, blockSize);
+
+  const auto numChannels = processor.getTotalNumOutputChannels();
+  juce::AudioBuffer<float> output{numChannels, NUM_BLOCKS * blockSize};
+  juce::AudioBuffer<float> buffer{numChannels, blockSize};
+  juce::MidiBuffer midi;
+
+  for (auto block = 0; block < NUM_BLOCKS; ++block) {
+    if (block % 3 == 0)
+      setParameter(processor, id::GAIN,
+                   0.25f + 0.25f * static_cast<float>((block / 3) % 4));
+    if (block % 5 == 0)
+      setParameter(processor, id::PAN,
+                   0.5f * static_cast<float>((block / 5) % 3));
+
+    for (auto i = 0; i < blockSize; ++i) {
+      const auto phase = juce::MathConstants<double>::twoPi * 220.0 *
+                         (block * blockSize + i) / SAMPLE_RATE;
+      for (auto channel = 0; channel < numChannels; ++channel) {
+        buffer.setSample(channel, i,
+                         0.5f * static_cast<float>(std::sin(phase)));
+      }
+    }
+
+    midi.clear();
+    midi.addEvent(
+        juce::MidiMessage::noteOn(1, 48 + block % 24, juce::uint8{100}),
+        (37 * block) % blockSize);
+    processor.processBlock(buffer, midi);
+
+    for (auto channel = 0; channel < numChannels; ++channel) {
+      output.copyFrom(channel, block * blockSize, buffer, channel, 0,
+                      blockSize);
+    }
+  }
+
+  return output;
+}
+
+// Index of the first sample of any channel that isn't 0, or -1
+int findFirstSound(const juce::AudioBuffer<float>& buffer) {
+  for (auto i = 0; i < buffer.getNumSamples(); ++i) {
+    for (auto channel = 0; channel < buffer.getNumChannels(); ++channel) {
+      if (!juce::exactlyEqual(buffer.getSample(channel, i), 0.f))
+        return i;
+    }
+  }
+  return -1;
+}
+
+class SubBlockTest final : public juce::UnitTest {
+public:
+  SubBlockTest() : juce::UnitTest{"Sub-block processing", "WebViewPlugin"} {}
+
+  void runTest() override {
+    beginTest("Sub-blocks start at every MIDI event");
+    {
+      juce::Random random{42};
+      juce::MidiBuffer midi;
+      std::vector<int> subBlockStarts;
+
+      for (const auto blockSize : BLOCK_SIZES) {
+        for (auto repetition = 0; repetition < 50; ++repetition) {
+          midi.clear();
+          for (auto event = random.nextInt(16); event > 0; --event) {
+            midi.addEvent(juce::MidiMessage::noteOn(1, 60, juce::uint8{100}),
+                          random.nextInt(blockSize));
+          }
+
+          for (const auto maxSubBlockSize : SUB_BLOCK_SIZES) {
+            subBlockStarts.clear();
+            auto end = 0;
+            auto numErrors = 0;
+            forEachSubBlock(blockSize, midi, maxSubBlockSize,
+                            [&](int start, int length) {
+                              if (start != end || length <= 0 ||
+                                  length > maxSubBlockSize)
+                                ++numErrors;
+                              subBlockStarts.push_back(start);
+                              end = start + length;
+                            });
+
+            expectEquals(end, blockSize, "Sub-blocks don't cover the block");
+            expectEquals(numErrors, 0,
+                         "Sub-blocks overlap, leave gaps or are too long");
+            for (const auto metadata : midi) {
+              expect(std::binary_search(subBlockStarts.begin(),
+                                        subBlockStarts.end(),
+                                        metadata.samplePosition),
+                     "No sub-block starts at the event at " +
+                         juce::String{metadata.samplePosition});
+            }
+          }
+        }
+      }
+    }
+
+    beginTest("Notes of the additive engine start at their event's sample");
+    for (const auto maxSubBlockSize : {0, 32}) {
+      for (const auto offset : {0, 1, 37, 100, 255}) {
+        constexpr auto BLOCK_SIZE = 256;
+        AudioPluginAudioProcessor processor;
+        setParameter(processor, id::HARMONIC_ENGINE, 1.f);
+        processor.setHarmonicValues(createHarmonicValues(8));
+        processor.setMaxSubBlockSize(maxSubBlockSize);
+        prepare(processor, SAMPLE_RATE, BLOCK_SIZE);
+
+        // Silent input: all that sounds is the synth
+        juce::AudioBuffer<float> buffer{processor.getTotalNumOutputChannels(),
+                                        BLOCK_SIZE};
+        buffer.clear();
+        juce::MidiBuffer midi;
+        midi.addEvent(juce::MidiMessage::noteOn(1, 60, juce::uint8{100}),
+                      offset);
+        processor.processBlock(buffer, midi);
+
+        // The oscillators and the attack both start from 0
+        const auto firstSound = findFirstSound(buffer);
+        expect(firstSound >= offset && firstSound <= offset + 2,
+               "Note at " + juce::String{offset} + " sounds from " +
+                   juce::String{firstSound});
+      }
+    }
+
+    beginTest("Rendering in sub-blocks matches rendering in whole blocks");
+    for (const auto blockSize : BLOCK_SIZES) {
+      const auto wholeBlocks = renderWithAutomation(blockSize, 0);
+
+      for (const auto maxSubBlockSize : SUB_BLOCK_SIZES) {
+        const auto subBlocks = renderWithAutomation(blockSize, maxSubBlockSize);
+        auto maxDifference = 0.f;
+        for (auto channel = 0; channel < wholeBlocks.getNumChannels();
+             ++channel) {
+          for (auto i = 0; i < wholeBlocks.getNumSamples(); ++i) {
+            maxDifference = juce::jmax(
+                maxDifference, std::abs(wholeBlocks.getSample(channel, i) -
+                                        subBlocks.getSample(channel, i)));
+          }
+        }
+
+        expectLessOrEqual(maxDifference, MAX_SUB_BLOCK_DIFFERENCE,
+                          juce::String{blockSize} + "-sample blocks in " +
+                              juce::String{maxSubBlockSize} +
+                              "-sample sub-blocks");
+      }
+    }
+  }
+};
+
+SubBlockTest subBlockTest;
+}  // namespace
+}  // namespace webview_plugin::test
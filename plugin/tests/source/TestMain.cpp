@@ -0,0 +1,40 @@
+#include <juce_core/juce_core.h>
+#include <juce_events/juce_events.h>
+#include <juce_gui_basics/juce_gui_basics.h>
+#include <iostream>
+
+/**
+ * Runs the unit tests of the audio processor and exits with 1 if any of them
+ * failed, so that CTest reports it.
+ *
+ * Usage:
+ *   JuceWebViewPluginTests [--test="Harmonic MIDI"]
+ */
+int main(int argc, char* argv[]) {
+  // The processor relies on the message manager, e.g., for async updates
+  const juce::ScopedJuceInitialiser_GUI juceInitialiser;
+  const juce::ArgumentList arguments{argc, argv};
+
+  juce::Array<juce::UnitTest*> tests;
+  const auto name = arguments.getValueForOption("--test").unquoted();
+  for (auto* test : juce::UnitTest::getAllTests()) {
+    if (name.isEmpty() || test->getName() == name)
+      tests.add(test);
+  }
+
+  if (tests.isEmpty()) {
+    std::cerr << "No test named " << name << std::endl;
+    return 1;
+  }
+
+  juce::UnitTestRunner runner;
+  runner.setAssertOnFailure(false);
+  runner.runTests(tests);
+
+  auto numFailures = 0;
+  for (auto i = 0; i < runner.getNumResults(); ++i) {
+    numFailures += runner.getResult(i)->failures;
+  }
+
+  return numFailures == 0 ? 0 : 1;
+}
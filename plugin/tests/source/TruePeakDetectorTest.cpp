@@ -0,0 +1,72 @@
+#include "JuceWebViewTutorial/TruePeakDetector.h"
+#include <juce_core/juce_core.h>
+#include <cmath>
+#include <vector>
+
+namespace webview_plugin::test {
+namespace {
+constexpr auto BLOCK_SIZE = 64;
+constexpr auto NUM_BLOCKS = 16;
+
+// Sample and true peak of a signal, with the samples that come out of the
+// interpolator late flushed by a block of silence
+struct Peaks {
+  float samplePeak = 0.f;
+  float truePeak = 0.f;
+};
+
+template <typename Generator>
+Peaks measure(Generator&& generator) {
+  TruePeakDetector detector;
+  detector.prepare(1, BLOCK_SIZE);
+
+  std::vector<float> block(BLOCK_SIZE);
+  Peaks peaks;
+  for (auto i = 0; i <= NUM_BLOCKS; ++i) {
+    for (auto n = 0; n < BLOCK_SIZE; ++n) {
+      block[static_cast<size_t>(n)] =
+          i < NUM_BLOCKS ? generator(i * BLOCK_SIZE + n) : 0.f;
+      peaks.samplePeak = juce::jmax(peaks.samplePeak,
+                                    std::abs(block[static_cast<size_t>(n)]));
+    }
+    peaks.truePeak = juce::jmax(
+        peaks.truePeak, detector.process(0, block.data(), block.size()));
+  }
+  return peaks;
+}
+
+class TruePeakDetectorTest final : public juce::UnitTest {
+public:
+  TruePeakDetectorTest()
+      : juce::UnitTest{"True peak detector", "WebViewPlugin"} {}
+
+  void runTest() override {
+    beginTest("The true peak of a sine at fs/4 is its amplitude");
+    {
+      // Samples at 0, 1, 0, -1 hit the peaks; samples at +-0.707 miss them
+      for (const auto phase : {0.0, 0.25 * juce::MathConstants<double>::pi}) {
+        const auto peaks = measure([phase](int n) {
+          return static_cast<float>(
+              std::sin(juce::MathConstants<double>::halfPi * n + phase));
+        });
+        expectWithinAbsoluteError(peaks.truePeak, 1.f, 0.02f);
+      }
+    }
+
+    beginTest("The true peak is never below the sample peak");
+    {
+      juce::Random random{11};
+      for (auto signal = 0; signal < 100; ++signal) {
+        const auto amplitude = random.nextFloat();
+        const auto peaks = measure([&random, amplitude](int) {
+          return amplitude * (2.f * random.nextFloat() - 1.f);
+        });
+        expectGreaterOrEqual(peaks.truePeak, peaks.samplePeak);
+      }
+    }
+  }
+};
+
+TruePeakDetectorTest truePeakDetectorTest;
+}  // namespace
+}  // namespace webview_plugin::test
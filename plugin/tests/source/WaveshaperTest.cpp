@@ -0,0 +1,113 @@
+#include "JuceWebViewTutorial/Waveshaper.h"
+#include <juce_core/juce_core.h>
+#include <cmath>
+#include <limits>
+#include <utility>
+
+namespace webview_plugin::test {
+namespace {
+// Inputs cover [-MAX_INPUT, MAX_INPUT] in steps of 1 / STEPS_PER_UNIT
+constexpr auto MAX_INPUT = 8;
+constexpr auto STEPS_PER_UNIT = 1024;
+
+juce::AudioBuffer<float> createRamp() {
+  constexpr auto NUM_SAMPLES = 2 * MAX_INPUT * STEPS_PER_UNIT + 1;
+  juce::AudioBuffer<float> ramp{1, NUM_SAMPLES};
+  for (auto i = 0; i < NUM_SAMPLES; ++i) {
+    ramp.setSample(0, i,
+                   static_cast<float>(i - MAX_INPUT * STEPS_PER_UNIT) /
+                       static_cast<float>(STEPS_PER_UNIT));
+  }
+  return ramp;
+}
+
+// Largest difference between a tanh kernel and std::tanh over the ramp
+template <typename TanhKernel>
+double getMaxKernelError(const TanhKernel& kernel) {
+  const auto ramp = createRamp();
+  auto maxError = 0.0;
+  for (auto i = 0; i < ramp.getNumSamples(); ++i) {
+    const auto x = ramp.getSample(0, i);
+    maxError = juce::jmax(
+        maxError, std::abs(static_cast<double>(kernel(x)) -
+                           std::tanh(static_cast<double>(x))));
+  }
+  return maxError;
+}
+
+// Largest difference between the shaper's curve and its formula, computed in
+// double precision, over the ramp
+template <typename Formula>
+double getMaxCurveError(const Waveshaper& shaper,
+                        ShaperType type,
+                        Formula&& formula) {
+  const auto ramp = createRamp();
+  auto shaped = ramp;
+  shaper.process(juce::dsp::AudioBlock<float>{shaped}, type);
+
+  auto maxError = 0.0;
+  for (auto i = 0; i < ramp.getNumSamples(); ++i) {
+    const auto x = static_cast<double>(ramp.getSample(0, i));
+    maxError = juce::jmax(
+        maxError,
+        std::abs(static_cast<double>(shaped.getSample(0, i)) - formula(x)));
+  }
+  return maxError;
+}
+
+class WaveshaperTest final : public juce::UnitTest {
+public:
+  WaveshaperTest() : juce::UnitTest{"Waveshaper", "WebViewPlugin"} {}
+
+  void runTest() override {
+    const LookupTableTanh lookupTableTanh;
+
+    beginTest("The tanh kernels stay within their error bounds");
+    expectLessOrEqual(getMaxKernelError(RationalTanh{}),
+                      static_cast<double>(RationalTanh::MAX_ERROR));
+    expectLessOrEqual(getMaxKernelError(lookupTableTanh),
+                      static_cast<double>(LookupTableTanh::MAX_ERROR));
+
+    beginTest("The lookup table clamps non-finite inputs");
+    {
+      const auto nan = std::numeric_limits<float>::quiet_NaN();
+      const auto infinity = std::numeric_limits<float>::infinity();
+      expect(std::isfinite(lookupTableTanh(nan)), "NaN gives a non-finite");
+      expectWithinAbsoluteError(lookupTableTanh(infinity), 1.f,
+                                LookupTableTanh::MAX_ERROR);
+      expectWithinAbsoluteError(lookupTableTanh(-infinity), -1.f,
+                                LookupTableTanh::MAX_ERROR);
+    }
+
+    beginTest("The curves match the distortion types' formulas");
+    for (const auto [mode, maxError] :
+         {std::pair{Waveshaper::Mode::rational, RationalTanh::MAX_ERROR},
+          std::pair{Waveshaper::Mode::lookupTable,
+                    LookupTableTanh::MAX_ERROR}}) {
+      Waveshaper shaper{lookupTableTanh};
+      shaper.setMode(mode);
+      const auto k = static_cast<double>(Waveshaper::SATURATION);
+
+      expectLessOrEqual(getMaxCurveError(shaper, ShaperType::tanh,
+                                         [k](double x) {
+                                           return std::tanh(k * x) /
+                                                  std::tanh(k);
+                                         }),
+                        static_cast<double>(maxError));
+      // The sigmoid as computed before the tanh kernels replaced it
+      expectLessOrEqual(
+          getMaxCurveError(shaper, ShaperType::sigmoid,
+                           [k](double x) {
+                             return 2.0 / (1.0 + std::exp(-k * x)) - 1.0;
+                           }),
+          static_cast<double>(maxError));
+      expectEquals(getMaxCurveError(shaper, ShaperType::none,
+                                    [](double x) { return x; }),
+                   0.0);
+    }
+  }
+};
+
+WaveshaperTest waveshaperTest;
+}  // namespace
+}  // namespace webview_plugin::test
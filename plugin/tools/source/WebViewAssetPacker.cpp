@@ -0,0 +1,66 @@
+#include <juce_core/juce_core.h>
+#include <iostream>
+#include "JuceWebViewTutorial/AssetBundle.h"
+
+/**
+ * Packs the web UI files into an asset bundle and prints its size.
+ *
+ * Usage:
+ *   WebViewAssetPacker --input=path/to/ui/public --output=webview_files.bin
+ */
+namespace webview_plugin::asset_bundle {
+namespace {
+int runPacker(const juce::ArgumentList& arguments) {
+  const auto input = arguments.getValueForOption("--input");
+  const auto output = arguments.getValueForOption("--output");
+
+  if (arguments.containsOption("--help|-h") || input.isEmpty() ||
+      output.isEmpty()) {
+    std::cout << "Usage: " << arguments.executableName
+              << " --input=path/to/ui/public --output=webview_files.bin"
+              << std::endl;
+    return input.isEmpty() || output.isEmpty() ? 1 : 0;
+  }
+
+  const auto workingDirectory = juce::File::getCurrentWorkingDirectory();
+  const auto inputDirectory = workingDirectory.getChildFile(input.unquoted());
+  const auto outputFile = workingDirectory.getChildFile(output.unquoted());
+
+  // Replace the bundle only once it's complete
+  juce::TemporaryFile temporaryFile{outputFile};
+  PackStatistics statistics;
+  {
+    juce::FileOutputStream stream{temporaryFile.getFile()};
+    if (stream.failedToOpen()) {
+      std::cerr << "Could not write " << outputFile.getFullPathName()
+                << std::endl;
+      return 1;
+    }
+
+    if (const auto result = pack(inputDirectory, stream, statistics);
+        result.failed()) {
+      std::cerr << result.getErrorMessage() << std::endl;
+      return 1;
+    }
+  }
+
+  if (!temporaryFile.overwriteTargetFileWithTemporary()) {
+    std::cerr << "Could not write " << outputFile.getFullPathName()
+              << std::endl;
+    return 1;
+  }
+
+  std::cout << "Packed " << statistics.numFiles << " web UI files ("
+            << statistics.numCompressedFiles << " compressed, "
+            << statistics.numExcludedFiles << " excluded): "
+            << statistics.inputBytes << " -> " << statistics.bundleBytes
+            << " bytes" << std::endl;
+  return 0;
+}
+}  // namespace
+}  // namespace webview_plugin::asset_bundle
+
+int main(int argc, char* argv[]) {
+  return webview_plugin::asset_bundle::runPacker(
+      juce::ArgumentList{argc, argv});
+}
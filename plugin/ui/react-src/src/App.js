@@ -4,6 +4,10 @@ import BypassButton from './components/BypassButton';
 import DistortionTypeSelector from './components/DistortionTypeSelector';
 import HarmonicEditor from './components/HarmonicEditor';
 import NoteSelector from './components/NoteSelector';
+import ProgramSelector from './components/ProgramSelector';
+import OutputMeter from './components/OutputMeter';
+import ProfilerView from './components/ProfilerView';
+import SpectrumView from './components/SpectrumView';
 
 const App = () => {
   // Function to format pan value display
@@ -30,6 +34,7 @@ const App = () => {
       </header>
       <main>
         <div className="controls-container">
+          <ProgramSelector />
           <SliderControl 
             paramId="GAIN" 
             title="Gain" 
@@ -43,6 +48,7 @@ const App = () => {
           />
           <BypassButton />
           <DistortionTypeSelector />
+          <OutputMeter />
           
           {/* Using our new NoteSelector component */}
           <NoteSelector
@@ -60,6 +66,10 @@ const App = () => {
             onHarmonicsChange={handleHarmonicsChange}
             rootNote={rootNote}
           />
+
+          <SpectrumView />
+
+          <ProfilerView />
         </div>
       </main>
     </div>
@@ -1,8 +1,9 @@
 import React, { useState, useEffect } from 'react';
-import { getChoiceState } from '../juceUtils';
+import { getChoiceState, getToggleState } from '../juceUtils';
 
 const DistortionTypeSelector = () => {
   const [distortionType, setDistortionType] = useState(0);
+  const [exciterEnabled, setExciterEnabled] = useState(false);
   const distortionOptions = ["None", "Tanh", "Sigmoid"];
   
   useEffect(() => {
@@ -18,11 +19,34 @@ const DistortionTypeSelector = () => {
       });
       
       // Cleanup listener on unmount
-      return () => {
+      const toggleExciter = () => {
+    const exciterState = getToggleState("HARMONIC_EXCITER");
+    if (exciterState) {
+      exciterState.setValue(!exciterEnabled);
+    }
+  };
+  
+  return () => {
         distortionState.valueChangedEvent.removeAllListeners();
       };
     }
   }, []);
+
+  useEffect(() => {
+    // The exciter is a separate parameter that replaces the distortion curve
+    const exciterState = getToggleState("HARMONIC_EXCITER");
+    if (exciterState) {
+      setExciterEnabled(exciterState.getValue());
+
+      exciterState.valueChangedEvent.addListener(() => {
+        setExciterEnabled(exciterState.getValue());
+      });
+
+      return () => {
+        exciterState.valueChangedEvent.removeAllListeners();
+      };
+    }
+  }, []);
   
   const handleDistortionChange = (e) => {
     const newIndex = parseInt(e.target.value, 10);
@@ -40,13 +64,23 @@ const DistortionTypeSelector = () => {
       <div className="control-header">
         <h3 className="control-title">Distortion Type</h3>
       </div>
-      <select value={distortionType} onChange={handleDistortionChange}>
+      <select
+        value={distortionType}
+        onChange={handleDistortionChange}
+        disabled={exciterEnabled}
+      >
         {distortionOptions.map((option, index) => (
           <option key={index} value={index}>
             {option}
           </option>
         ))}
       </select>
+      <button
+        onClick={toggleExciter}
+        className={exciterEnabled ? 'active' : ''}
+      >
+        Harmonic Exciter
+      </button>
     </div>
   );
 };
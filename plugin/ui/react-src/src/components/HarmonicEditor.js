@@ -1,5 +1,19 @@
-import React, { useState, useCallback, useEffect } from 'react';
+import React, { useState, useCallback, useEffect, useRef } from 'react';
 import BarEditor from './BarEditor';
+import {
+  addBackendEventListener,
+  callNativeFunction,
+  decodeFloat32Array,
+  encodeFloat32Array
+} from '../juceUtils';
+
+// Sequence numbers must grow across page reloads too, because the plugin drops
+// updates whose number isn't higher than the last one it applied
+let lastSequenceNumber = 0;
+const nextSequenceNumber = () => {
+  lastSequenceNumber = Math.max(lastSequenceNumber + 1, Date.now());
+  return lastSequenceNumber;
+};
 
 /**
  * Harmonic Editor component using the BarEditor for adjusting harmonic amplitudes
@@ -51,15 +65,87 @@ const HarmonicEditor = ({
     };
   };
   
-  // Send harmonic values to JUCE backend whenever they change
+  // Values the plugin already has, and changes not sent yet. The plugin's
+  // harmonics replace the initial values, so those aren't sent.
+  const sentHarmonicsRef = useRef([...harmonics]);
+  const pendingChangesRef = useRef(new Map());
+  const animationFrameRef = useRef(null);
+
+  // Send only the changed harmonics, at most once per display frame
   useEffect(() => {
-    // Send to JUCE using the nativeFunction
-    if (typeof window.Juce !== 'undefined') {
-      window.Juce.callNativeFunction("updateHarmonics", ["updateHarmonics", harmonics], (result) => {
-        console.log("Harmonic values sent to plugin:", result);
-      });
+    harmonics.forEach((value, index) => {
+      if (sentHarmonicsRef.current[index] !== value) {
+        pendingChangesRef.current.set(index, value);
+      } else {
+        pendingChangesRef.current.delete(index);
+      }
+    });
+
+    if (pendingChangesRef.current.size === 0 || animationFrameRef.current !== null) {
+      return;
     }
+
+    animationFrameRef.current = requestAnimationFrame(() => {
+      animationFrameRef.current = null;
+
+      // (index, value) pairs
+      const deltas = new Float32Array(2 * pendingChangesRef.current.size);
+      let offset = 0;
+      pendingChangesRef.current.forEach((value, index) => {
+        deltas[offset++] = index;
+        deltas[offset++] = value;
+        sentHarmonicsRef.current[index] = value;
+      });
+      pendingChangesRef.current.clear();
+
+      callNativeFunction(
+        'nativeFunction',
+        'updateHarmonicsDelta',
+        nextSequenceNumber(),
+        encodeFloat32Array(deltas)
+      ).catch(() => {});
+    });
   }, [harmonics]);
+
+  // The harmonics are host-automatable parameters: follow their values
+  useEffect(() => {
+    const applyFromPlugin = (pairs) => {
+      setHarmonics((previous) => {
+        const next = [...previous];
+        pairs.forEach(([index, value]) => {
+          if (index < numHarmonics) {
+            next[index] = value;
+            sentHarmonicsRef.current[index] = value;
+          }
+        });
+        return next;
+      });
+    };
+
+    callNativeFunction('nativeFunction', 'getHarmonics')
+      .then((payload) => {
+        applyFromPlugin(Array.from(decodeFloat32Array(payload), (value, index) => [index, value]));
+      })
+      .catch(() => {});
+
+    // At most one event per display frame, with (index, value) pairs
+    return addBackendEventListener('harmonicsChanged', (payload) => {
+      const deltas = decodeFloat32Array(payload);
+      const pairs = [];
+      for (let i = 0; i + 1 < deltas.length; i += 2) {
+        pairs.push([deltas[i], deltas[i + 1]]);
+      }
+      applyFromPlugin(pairs);
+    });
+  }, [numHarmonics]);
+
+  useEffect(() => {
+    return () => {
+      if (animationFrameRef.current !== null) {
+        cancelAnimationFrame(animationFrameRef.current);
+      }
+    };
+  }, []);
   
   // Handle harmonic value changes
   const handleHarmonicsChange = useCallback((newHarmonics) => {
@@ -0,0 +1,122 @@
+import React, { useState, useEffect } from 'react';
+import {
+  addBackendEventListener,
+  callNativeFunction,
+  decodeFloat32Array,
+} from '../juceUtils';
+
+const MIN_DB = -60;
+
+const toDecibels = (gain) => (gain > 0 ? 20 * Math.log10(gain) : -Infinity);
+
+// Position of a level on the meter, 0 to 100%
+const toPercent = (gain) =>
+  Math.max(0, Math.min(100, 100 * (1 - toDecibels(gain) / MIN_DB)));
+
+const formatDecibels = (gain) => {
+  const decibels = toDecibels(gain);
+  return decibels > MIN_DB ? `${decibels.toFixed(1)} dB` : '-inf';
+};
+
+// LevelMeter reports silence as this loudness
+const MIN_LOUDNESS = -100;
+
+const formatLoudness = (lufs) =>
+  lufs > MIN_LOUDNESS ? `${lufs.toFixed(1)} LUFS` : '-inf';
+
+const OutputMeter = ({ title = "Output", frameRate = 30 }) => {
+  const [levels, setLevels] = useState({
+    peak: [],
+    rms: [],
+    truePeak: [],
+    momentary: MIN_LOUDNESS,
+    shortTerm: MIN_LOUDNESS,
+  });
+  // Metering true peak and loudness costs CPU: both are off until enabled
+  const [meters, setMeters] = useState({ truePeak: false, loudness: false });
+
+  useEffect(() => {
+    callNativeFunction('nativeFunction', 'setMeterFrameRate', frameRate).catch(
+      () => {}
+    );
+  }, [frameRate]);
+
+  useEffect(() => {
+    callNativeFunction('nativeFunction', 'setEnabledMeters', meters).catch(
+      () => {}
+    );
+  }, [meters]);
+
+  useEffect(() => {
+    // Frames hold the peak, the RMS and the true peak levels of all channels
+    // followed by the momentary and the short-term loudness
+    return addBackendEventListener('meterFrame', (payload) => {
+      const frame = decodeFloat32Array(payload);
+      const numChannels = (frame.length - 2) / 3;
+      setLevels({
+        peak: Array.from(frame.subarray(0, numChannels)),
+        rms: Array.from(frame.subarray(numChannels, 2 * numChannels)),
+        truePeak: Array.from(frame.subarray(2 * numChannels, 3 * numChannels)),
+        momentary: frame[3 * numChannels],
+        shortTerm: frame[3 * numChannels + 1],
+      });
+    });
+  }, []);
+
+  const toggleMeter = (name) =>
+    setMeters((current) => ({ ...current, [name]: !current[name] }));
+
+  return (
+    <div className="control output-meter">
+      <div className="control-header">
+        <h3 className="control-title">{title}</h3>
+      </div>
+      {levels.peak.map((peak, channel) => (
+        <div className="meter-channel" key={channel}>
+          <div className="meter-track">
+            <div
+              className="meter-rms"
+              style={{ width: `${toPercent(levels.rms[channel])}%` }}
+            />
+            <div
+              className="meter-peak"
+              style={{ left: `${toPercent(peak)}%` }}
+            />
+          </div>
+          <span className="meter-value">{formatDecibels(peak)}</span>
+          {meters.truePeak && (
+            <span className="meter-value">
+              {formatDecibels(levels.truePeak[channel])} TP
+            </span>
+          )}
+        </div>
+      ))}
+      {meters.loudness && (
+        <div className="meter-loudness">
+          <span>M {formatLoudness(levels.momentary)}</span>
+          <span>S {formatLoudness(levels.shortTerm)}</span>
+        </div>
+      )}
+      <div className="meter-options">
+        <label>
+          <input
+            type="checkbox"
+            checked={meters.truePeak}
+            onChange={() => toggleMeter('truePeak')}
+          />
+          True peak
+        </label>
+        <label>
+          <input
+            type="checkbox"
+            checked={meters.loudness}
+            onChange={() => toggleMeter('loudness')}
+          />
+          Loudness
+        </label>
+      </div>
+    </div>
+  );
+};
+
+export default OutputMeter;
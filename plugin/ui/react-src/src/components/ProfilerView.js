@@ -0,0 +1,82 @@
+import React, { useState, useEffect } from 'react';
+import { getBackendResourceAddress } from '../juceUtils';
+
+const POLL_INTERVAL_MS = 500;
+
+// Percentage of the real-time budget of a block
+const formatShare = (share) => `${(100 * share).toFixed(1)}%`;
+
+const ProfilerView = ({ title = "Audio Thread Load" }) => {
+  const [profile, setProfile] = useState(null);
+
+  useEffect(() => {
+    let cancelled = false;
+
+    const poll = async () => {
+      try {
+        const response = await fetch(getBackendResourceAddress('profile.json'));
+        const data = await response.json();
+        if (!cancelled) {
+          setProfile(data);
+        }
+      } catch (e) {
+        // The plugin isn't reachable, e.g., outside of a WebView
+      }
+    };
+
+    poll();
+    const interval = setInterval(poll, POLL_INTERVAL_MS);
+
+    return () => {
+      cancelled = true;
+      clearInterval(interval);
+    };
+  }, []);
+
+  if (!profile || !profile.enabled) {
+    return null;
+  }
+
+  return (
+    <div className="control profiler-view">
+      <div className="control-header">
+        <h3 className="control-title">{title}</h3>
+        {profile.droppedRecords > 0 && (
+          <span className="control-value">{profile.droppedRecords} dropped</span>
+        )}
+      </div>
+      <table className="profiler-table">
+        <thead>
+          <tr>
+            <th>Stage</th>
+            <th>Recent</th>
+            <th>p50</th>
+            <th>p99</th>
+            <th>Max (µs)</th>
+          </tr>
+        </thead>
+        <tbody>
+          {profile.stages.map((stage) => (
+            <tr key={stage.name}>
+              <td>{stage.name}</td>
+              <td>
+                <div className="profiler-bar-track">
+                  <div
+                    className="profiler-bar"
+                    style={{ width: `${Math.min(100, 100 * stage.recentBudgetShare)}%` }}
+                  />
+                </div>
+                {formatShare(stage.recentBudgetShare)}
+              </td>
+              <td>{formatShare(stage.p50BudgetShare)}</td>
+              <td>{formatShare(stage.p99BudgetShare)}</td>
+              <td>{stage.maxUs.toFixed(0)}</td>
+            </tr>
+          ))}
+        </tbody>
+      </table>
+    </div>
+  );
+};
+
+export default ProfilerView;
@@ -0,0 +1,81 @@
+import React, { useState, useEffect } from 'react';
+import { addBackendEventListener, callNativeFunction } from '../juceUtils';
+
+const ProgramSelector = ({ title = "Program" }) => {
+  const [programs, setPrograms] = useState({ names: [], current: 0 });
+  // A name only: the plugin keeps banks in the user's presets folder
+  const [bankName, setBankName] = useState('');
+  const [newProgramName, setNewProgramName] = useState('');
+  const [error, setError] = useState(null);
+
+  // Native functions complete with {names, current} or an error string
+  const handleResult = (result) => {
+    if (typeof result === 'string') {
+      setError(result);
+      return;
+    }
+    setError(null);
+    setPrograms(result);
+  };
+
+  useEffect(() => {
+    callNativeFunction('nativeFunction', 'getPrograms').then(handleResult).catch(() => {});
+
+    // Also sent when the host switches programs
+    return addBackendEventListener('programChanged', handleResult);
+  }, []);
+
+  const handleProgramChange = (e) => {
+    const index = parseInt(e.target.value, 10);
+    setPrograms((previous) => ({ ...previous, current: index }));
+    callNativeFunction('nativeFunction', 'setCurrentProgram', index).catch(() => {});
+  };
+
+  const loadBank = () => {
+    callNativeFunction('nativeFunction', 'loadPresetBank', bankName).then(handleResult).catch(() => {});
+  };
+
+  const saveProgram = () => {
+    callNativeFunction('nativeFunction', 'savePresetBank', bankName, newProgramName)
+      .then(handleResult)
+      .catch(() => {});
+  };
+
+  return (
+    <div className="control program-selector">
+      <div className="control-header">
+        <h3 className="control-title">{title}</h3>
+        {error && <span className="control-value">{error}</span>}
+      </div>
+      <select
+        value={programs.current}
+        onChange={handleProgramChange}
+        disabled={programs.names.length === 0}
+      >
+        {programs.names.map((name, index) => (
+          <option key={index} value={index}>
+            {name || `Program ${index + 1}`}
+          </option>
+        ))}
+      </select>
+      <input
+        type="text"
+        placeholder="Preset bank name"
+        value={bankName}
+        onChange={(e) => setBankName(e.target.value)}
+      />
+      <button onClick={loadBank} disabled={!bankName}>Load</button>
+      <input
+        type="text"
+        placeholder="New program name"
+        value={newProgramName}
+        onChange={(e) => setNewProgramName(e.target.value)}
+      />
+      <button onClick={saveProgram} disabled={!bankName || !newProgramName}>
+        Save
+      </button>
+    </div>
+  );
+};
+
+export default ProgramSelector;
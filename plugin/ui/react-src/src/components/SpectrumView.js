@@ -0,0 +1,48 @@
+import React, { useEffect, useRef } from 'react';
+import { addBackendEventListener, decodeFloat32Array } from '../juceUtils';
+
+const MIN_DB = -100;
+const MAX_DB = 0;
+
+const SpectrumView = ({ title = "Spectrum", width = 512, height = 160 }) => {
+  const canvasRef = useRef(null);
+
+  useEffect(() => {
+    // Frames arrive at display rate: draw them directly instead of going
+    // through React state
+    return addBackendEventListener('spectrumFrame', (payload) => {
+      const canvas = canvasRef.current;
+      if (!canvas) return;
+
+      const bands = decodeFloat32Array(payload);
+      const context = canvas.getContext('2d');
+      const toY = (decibels) =>
+        canvas.height *
+        (1 - (Math.max(MIN_DB, Math.min(MAX_DB, decibels)) - MIN_DB) / (MAX_DB - MIN_DB));
+
+      context.clearRect(0, 0, canvas.width, canvas.height);
+      context.beginPath();
+      context.moveTo(0, canvas.height);
+      bands.forEach((decibels, band) => {
+        context.lineTo((band / (bands.length - 1)) * canvas.width, toY(decibels));
+      });
+      context.lineTo(canvas.width, canvas.height);
+      context.closePath();
+      context.fillStyle = 'rgba(142, 68, 173, 0.4)';
+      context.strokeStyle = '#8e44ad';
+      context.fill();
+      context.stroke();
+    });
+  }, []);
+
+  return (
+    <div className="control spectrum-view">
+      <div className="control-header">
+        <h3 className="control-title">{title}</h3>
+      </div>
+      <canvas ref={canvasRef} width={width} height={height} />
+    </div>
+  );
+};
+
+export default SpectrumView;
@@ -71,4 +71,66 @@ export const callNativeFunction = (functionName, ...args) => {
       reject(e);
     }
   });
-};
\ No newline at end of file
+};
+
+/**
+ * Get the address of a resource served by the plugin's resource provider
+ * @param {string} path - The path of the resource, e.g., "profile.json"
+ * @returns {string} - Absolute address that works from the bundled UI and from the dev server
+ */
+export const getBackendResourceAddress = (path) => {
+  const platform =
+    window.__JUCE__?.initialisationData?.__juce__platform?.[0] ?? '';
+
+  if (platform === 'windows' || platform === 'android') {
+    return `https://juce.backend/${path}`;
+  }
+  if (platform === 'macos' || platform === 'ios' || platform === 'linux') {
+    return `juce://juce.backend/${path}`;
+  }
+
+  // Not running inside the plugin, e.g., in a regular browser
+  return `/${path}`;
+};
+
+/**
+ * Listen to an event emitted by the plugin
+ * @param {string} eventId - The ID of the event
+ * @param {Function} callback - Called with the event's payload
+ * @returns {Function} - Removes the listener
+ */
+export const addBackendEventListener = (eventId, callback) => {
+  const backend = window.__JUCE__?.backend;
+  if (!backend) return () => {};
+
+  const token = backend.addEventListener(eventId, callback);
+  return () => backend.removeEventListener(token);
+};
+
+/**
+ * Decode base64-encoded little-endian float32 values
+ * @param {string} base64 - The encoded values
+ * @returns {Float32Array} - The decoded values
+ */
+export const decodeFloat32Array = (base64) => {
+  const binary = atob(base64);
+  const bytes = new Uint8Array(binary.length);
+  for (let i = 0; i < binary.length; ++i) {
+    bytes[i] = binary.charCodeAt(i);
+  }
+  return new Float32Array(bytes.buffer, 0, bytes.length >> 2);
+};
+
+/**
+ * Encode float32 values as base64, the counterpart of decodeFloat32Array
+ * @param {Float32Array} values - The values to encode
+ * @returns {string} - The encoded values
+ */
+export const encodeFloat32Array = (values) => {
+  const bytes = new Uint8Array(values.buffer, values.byteOffset, values.byteLength);
+  let binary = '';
+  for (let i = 0; i < bytes.length; ++i) {
+    binary += String.fromCharCode(bytes[i]);
+  }
+  return btoa(binary);
+};
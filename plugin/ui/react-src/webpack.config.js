@@ -1,10 +1,14 @@
 const path = require('path');
 const HtmlWebpackPlugin = require('html-webpack-plugin');
 
-module.exports = {
+// `--env outputPath=<dir>` builds into another folder; CMake builds the UI
+// into its build tree that way
+module.exports = (env = {}) => ({
   entry: './src/index.js',
   output: {
-    path: path.resolve(__dirname, '../public'),
+    path: env.outputPath
+      ? path.resolve(env.outputPath)
+      : path.resolve(__dirname, '../public'),
     filename: 'js/bundle.js',
     clean: true
   },
@@ -42,4 +46,4 @@ module.exports = {
     port: 8080,
     hot: true
   }
-};
\ No newline at end of file
+});